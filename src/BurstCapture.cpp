@@ -0,0 +1,252 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "BurstCapture.h"
+#include "ExportManager.h"
+#include "ImageHash.h"
+#include "SpectacleCore.h"
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+BurstCapture::BurstCapture(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_roleNames[FrameIdRole] = "frameId"_ba;
+    m_roleNames[TimestampRole] = "timestamp"_ba;
+    m_roleNames[FrameSizeRole] = "frameSize"_ba;
+}
+
+QHash<int, QByteArray> BurstCapture::roleNames() const
+{
+    return m_roleNames;
+}
+
+QVariant BurstCapture::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid)) {
+        return {};
+    }
+    const auto &frame = m_frames[index.row()];
+    if (role == FrameIdRole) {
+        return frame.id;
+    } else if (role == TimestampRole) {
+        return frame.timestamp;
+    } else if (role == FrameSizeRole) {
+        return frame.image.deviceIndependentSize();
+    }
+    return {};
+}
+
+int BurstCapture::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return m_frames.size();
+}
+
+void BurstCapture::start(int count, int intervalMsec)
+{
+    clear();
+    m_interval = std::max(0, intervalMsec);
+    setRemaining(count > 1 ? std::min(count, maximumCapacity) : 0);
+}
+
+void BurstCapture::cancel()
+{
+    setRemaining(0);
+}
+
+bool BurstCapture::isActive() const
+{
+    return m_remaining > 0;
+}
+
+int BurstCapture::remaining() const
+{
+    return m_remaining;
+}
+
+int BurstCapture::interval() const
+{
+    return m_interval;
+}
+
+int BurstCapture::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+int BurstCapture::droppedDuplicates() const
+{
+    return m_droppedDuplicates;
+}
+
+bool BurstCapture::isExporting() const
+{
+    return m_exporting;
+}
+
+bool BurstCapture::addFrame(const QImage &image)
+{
+    if (image.isNull()) {
+        return false;
+    }
+    setRemaining(m_remaining - 1);
+
+    const auto hash = ImageHash::pixelHash(image);
+    const bool duplicate = std::any_of(m_frames.cbegin(), m_frames.cend(), [&](const Frame &frame) {
+        return ImageHash::samePixels(frame.image, frame.hash, image, hash);
+    });
+    if (duplicate) {
+        ++m_droppedDuplicates;
+        Q_EMIT countChanged();
+        return false;
+    }
+
+    if (m_frames.size() >= maximumCapacity) {
+        beginRemoveRows({}, 0, 0);
+        m_frames.pop_front();
+        endRemoveRows();
+    }
+    const int row = m_frames.size();
+    beginInsertRows({}, row, row);
+    m_frames.push_back({m_nextId++, hash, image, QDateTime::currentDateTime()});
+    endInsertRows();
+    setCurrentIndex(row);
+    Q_EMIT countChanged();
+    return true;
+}
+
+QImage BurstCapture::frame(int row) const
+{
+    if (row < 0 || row >= int(m_frames.size())) {
+        return {};
+    }
+    return m_frames[row].image;
+}
+
+QImage BurstCapture::frameForId(quint64 id) const
+{
+    for (const auto &frame : m_frames) {
+        if (frame.id == id) {
+            return frame.image;
+        }
+    }
+    return {};
+}
+
+QImage BurstCapture::lastFrame() const
+{
+    return m_frames.empty() ? QImage{} : m_frames.back().image;
+}
+
+void BurstCapture::select(int row)
+{
+    const auto image = frame(row);
+    if (image.isNull() || row == m_currentIndex) {
+        return;
+    }
+    setCurrentIndex(row);
+    auto document = SpectacleCore::instance()->annotationDocument();
+    document->clearAnnotations();
+    document->setBaseImage(image);
+    ExportManager::instance()->setImage(image);
+    ExportManager::instance()->cancelQRCodeScan();
+    ExportManager::instance()->setTimestamp(m_frames[row].timestamp);
+}
+
+QUrl BurstCapture::exportAll()
+{
+    auto exportManager = ExportManager::instance();
+    SpectacleCore::instance()->syncExportImage();
+    const auto currentImage = exportManager->image();
+    const auto currentTimestamp = exportManager->timestamp();
+    QUrl lastUrl;
+    m_exporting = true;
+    for (const auto &frame : m_frames) {
+        exportManager->setImage(frame.image);
+        exportManager->setTimestamp(frame.timestamp);
+        // The autosave filename is incremented when the file already exists,
+        // so frames taken within the same second don't overwrite each other.
+        lastUrl = exportManager->getAutosaveFilename();
+        exportManager->exportImage(ExportManager::Save, lastUrl);
+    }
+    m_exporting = false;
+    exportManager->setImage(currentImage);
+    exportManager->setTimestamp(currentTimestamp);
+    if (!lastUrl.isEmpty()) {
+        Q_EMIT framesExported(lastUrl);
+    }
+    return lastUrl;
+}
+
+void BurstCapture::clear()
+{
+    if (!m_frames.empty()) {
+        beginResetModel();
+        m_frames.clear();
+        endResetModel();
+    }
+    m_droppedDuplicates = 0;
+    setCurrentIndex(-1);
+    Q_EMIT countChanged();
+}
+
+void BurstCapture::setRemaining(int remaining)
+{
+    remaining = std::max(0, remaining);
+    if (m_remaining == remaining) {
+        return;
+    }
+    const bool wasActive = isActive();
+    m_remaining = remaining;
+    Q_EMIT remainingChanged();
+    if (wasActive != isActive()) {
+        Q_EMIT activeChanged();
+        if (wasActive) {
+            Q_EMIT finished();
+        }
+    }
+}
+
+void BurstCapture::setCurrentIndex(int index)
+{
+    if (m_currentIndex == index) {
+        return;
+    }
+    m_currentIndex = index;
+    Q_EMIT currentIndexChanged();
+}
+
+BurstImageProvider::BurstImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage BurstImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    bool ok = false;
+    const auto frameId = id.toULongLong(&ok);
+    if (!ok) {
+        return {};
+    }
+    auto image = SpectacleCore::instance()->burstCapture()->frameForId(frameId);
+    if (image.isNull()) {
+        return {};
+    }
+    if (size) {
+        *size = image.size();
+    }
+    if (requestedSize.width() > 0 && requestedSize.height() > 0) {
+        return image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    } else if (requestedSize.height() > 0) {
+        return image.scaledToHeight(requestedSize.height(), Qt::SmoothTransformation);
+    } else if (requestedSize.width() > 0) {
+        return image.scaledToWidth(requestedSize.width(), Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+#include "moc_BurstCapture.cpp"
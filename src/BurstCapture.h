@@ -0,0 +1,128 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QImage>
+#include <QQmlEngine>
+#include <QQuickImageProvider>
+
+#include <deque>
+
+/**
+ * Takes a fixed number of captures at a fixed interval and keeps them in a bounded ring.
+ *
+ * Consecutive frames that are pixel for pixel identical to a frame already in the ring
+ * are dropped, so a burst of a static screen doesn't use more memory than a single frame.
+ * When the ring is full, the oldest frame is evicted.
+ *
+ * The model is shown as a filmstrip in the viewer window. Frames can be picked to replace
+ * the image being annotated or exported in bulk.
+ */
+class BurstCapture : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Use SpectacleCore.burstCapture")
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged FINAL)
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged FINAL)
+    Q_PROPERTY(int remaining READ remaining NOTIFY remainingChanged FINAL)
+    Q_PROPERTY(int currentIndex READ currentIndex NOTIFY currentIndexChanged FINAL)
+    Q_PROPERTY(int droppedDuplicates READ droppedDuplicates NOTIFY countChanged FINAL)
+
+public:
+    enum {
+        FrameIdRole = Qt::UserRole + 1,
+        TimestampRole = Qt::UserRole + 2,
+        FrameSizeRole = Qt::UserRole + 3,
+    };
+
+    // The largest number of frames that can be kept at once.
+    static constexpr int maximumCapacity = 64;
+
+    explicit BurstCapture(QObject *parent = nullptr);
+
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * Clear the ring and prepare to receive `count` frames taken every `intervalMsec` milliseconds.
+     * A count less than 2 means burst mode is not used.
+     */
+    void start(int count, int intervalMsec);
+    void cancel();
+
+    bool isActive() const;
+    int remaining() const;
+    int interval() const;
+    int currentIndex() const;
+    int droppedDuplicates() const;
+    bool isExporting() const;
+
+    /**
+     * Add a frame to the ring. Returns false if the frame was a duplicate of one already in the ring.
+     * Decrements the number of remaining captures either way.
+     */
+    bool addFrame(const QImage &image);
+
+    QImage frame(int row) const;
+    QImage frameForId(quint64 id) const;
+    QImage lastFrame() const;
+
+    /**
+     * Use the frame as the image in the annotation document and export image.
+     */
+    Q_INVOKABLE void select(int row);
+
+    /**
+     * Save every frame in the ring with an automatically generated file name.
+     * Returns the URL of the last saved frame.
+     */
+    Q_INVOKABLE QUrl exportAll();
+
+    void clear();
+
+Q_SIGNALS:
+    void countChanged();
+    void activeChanged();
+    void remainingChanged();
+    void currentIndexChanged();
+    void finished();
+    void framesExported(const QUrl &lastUrl);
+
+private:
+    void setRemaining(int remaining);
+    void setCurrentIndex(int index);
+
+    struct Frame {
+        quint64 id;
+        size_t hash;
+        QImage image;
+        QDateTime timestamp;
+    };
+
+    std::deque<Frame> m_frames;
+    QHash<int, QByteArray> m_roleNames;
+    quint64 m_nextId = 0;
+    int m_remaining = 0;
+    int m_interval = 0;
+    int m_currentIndex = -1;
+    int m_droppedDuplicates = 0;
+    bool m_exporting = false;
+};
+
+/**
+ * Provides scaled down frames from SpectacleCore's BurstCapture to QML Image items.
+ * Use "image://burst/<frameId>" as the source.
+ */
+class BurstImageProvider : public QQuickImageProvider
+{
+public:
+    BurstImageProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+};
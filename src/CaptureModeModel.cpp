@@ -38,6 +38,7 @@ CaptureModeModel::CaptureModeModel(QObject *parent)
     m_roleNames[CaptureModeRole] = "captureMode"_ba;
     m_roleNames[Qt::DisplayRole] = "display"_ba;
     m_roleNames[ShortcutsRole] = "shortcuts"_ba;
+    m_roleNames[BurstCapableRole] = "burstCapable"_ba;
 
     auto platform = SpectacleCore::instance()->imagePlatform();
     connect(platform, &ImagePlatform::supportedGrabModesChanged, this, [this, platform]() {
@@ -64,6 +65,8 @@ QVariant CaptureModeModel::data(const QModelIndex &index, int role) const
         ret = m_data.at(row).label;
     } else if (role == ShortcutsRole) {
         ret = m_data.at(row).shortcuts;
+    } else if (role == BurstCapableRole) {
+        ret = isBurstCapable(m_data.at(row).captureMode);
     }
     return ret;
 }
@@ -168,4 +171,16 @@ QString CaptureModeModel::captureModeLabel(CaptureMode mode)
     return QString{};
 }
 
+bool CaptureModeModel::isBurstCapable(CaptureMode mode)
+{
+    // Region selection and interactive window selection need user input for every capture.
+    if (mode == CaptureMode::RectangularRegion) {
+        return false;
+    }
+    if (mode == CaptureMode::WindowUnderCursor) {
+        return !qGuiApp->nativeInterface<QNativeInterface::QWaylandApplication>();
+    }
+    return true;
+}
+
 #include "moc_CaptureModeModel.cpp"
@@ -35,6 +35,7 @@ public:
     enum {
         CaptureModeRole = Qt::UserRole + 1,
         ShortcutsRole = Qt::UserRole + 2,
+        BurstCapableRole = Qt::UserRole + 3,
     };
 
     QHash<int, QByteArray> roleNames() const override;
@@ -47,6 +48,11 @@ public:
 
     static QString captureModeLabel(CaptureMode mode);
 
+    /**
+     * Whether the capture mode can be used to take several screenshots in a row without user input.
+     */
+    static bool isBurstCapable(CaptureMode mode);
+
 Q_SIGNALS:
     void captureModesChanged();
     void countChanged();
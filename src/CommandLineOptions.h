@@ -109,10 +109,40 @@ struct CommandLineOptions {
         i18n("Open and edit existing screenshot file"),
         u"existingFileName"_s
     };
+    const QCommandLineOption burst = {
+        {u"B"_s, u"burst"_s},
+        i18n("Take the given number of screenshots in a row. In background mode, all of them are saved"),
+        u"count"_s
+    };
+    const QCommandLineOption burstInterval = {
+        {u"burst-interval"_s},
+        i18n("Time to wait between screenshots in burst mode (in milliseconds)"),
+        u"intervalMsec"_s
+    };
+    const QCommandLineOption periodic = {
+        {u"periodic"_s},
+        i18n("Take a screenshot at the given interval (in milliseconds) and save it until Spectacle is closed or stopped via DBus"),
+        u"intervalMsec"_s
+    };
+    const QCommandLineOption skipUnchanged = {
+        {u"skip-unchanged"_s},
+        i18n("In periodic capture mode, do not save screenshots identical to the previous one")
+    };
+    const QCommandLineOption compare = {
+        {u"compare"_s},
+        i18n("Compare the screenshot or the image opened with --edit-existing against the given image and mark the differences"),
+        u"fileName"_s
+    };
+    const QCommandLineOption compareTolerance = {
+        {u"compare-tolerance"_s},
+        i18n("The largest difference of a color channel (0-255) that is not marked as a difference when comparing images"),
+        u"tolerance"_s
+    };
 
     const QList<QCommandLineOption> allOptions = {
         fullscreen, current, activeWindow, windowUnderCursor, transientOnly, region,  record,      launchOnly, gui,          background, dbus,
         noNotify,   output,  delay,        copyImage,         copyPath,      onClick, newInstance, pointer,    noDecoration, noShadow,   editExisting,
+        burst,      burstInterval, periodic, skipUnchanged, compare, compareTolerance,
     };
 
     // Keep order in sync with allOptions
@@ -139,6 +169,12 @@ struct CommandLineOptions {
         NoDecoration,
         NoShadow,
         EditExisting,
+        Burst,
+        BurstInterval,
+        Periodic,
+        SkipUnchanged,
+        Compare,
+        CompareTolerance,
         TotalOptions
     };
 };
@@ -6,6 +6,9 @@
 
 #include "ExportManager.h"
 #include "ImageMetaData.h"
+#include "QRCodeScanner.h"
+#include "ScreenshotIndex.h"
+#include "ThumbnailCache.h"
 #include "settings.h"
 #include "DebugUtils.h"
 #include <kio_version.h>
@@ -38,17 +41,69 @@
 #include <KRecentDocument>
 #include <KSharedConfig>
 #include <KSystemClipboard>
-#include <Prison/ImageScanner>
-#include <Prison/ScanResult>
 
 using namespace Qt::StringLiterals;
 
+// Clipboard data that encodes the image with the preferred format only when it is requested.
+// The raw image is usually what gets pasted, so there's no reason to make copying wait for an
+// encode. A result from ExportManager::preEncode() is used if there is one.
+class LazyImageMimeData : public QMimeData
+{
+public:
+    LazyImageMimeData(const QString &mimeType, const QImage &image, const QByteArray &suffix, const QFuture<QByteArray> &preEncoded)
+        : m_mimeType(mimeType)
+        , m_image(image)
+        , m_suffix(suffix)
+        , m_preEncoded(preEncoded)
+    {
+    }
+
+    QStringList formats() const override
+    {
+        auto formats = QMimeData::formats();
+        // First so that it gets chosen first.
+        formats.prepend(m_mimeType);
+        return formats;
+    }
+
+    bool hasFormat(const QString &mimeType) const override
+    {
+        return mimeType == m_mimeType || QMimeData::hasFormat(mimeType);
+    }
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QMetaType type) const override
+    {
+        if (mimeType != m_mimeType) {
+            return QMimeData::retrieveData(mimeType, type);
+        }
+        if (m_encoded.isEmpty() && m_preEncoded.isValid()) {
+            m_encoded = m_preEncoded.result();
+        }
+        if (m_encoded.isEmpty()) {
+            QBuffer buffer(&m_encoded);
+            buffer.open(QIODevice::WriteOnly);
+            ExportManager::encodeImage(m_image, &buffer, m_suffix);
+        }
+        return m_encoded;
+    }
+
+private:
+    const QString m_mimeType;
+    const QImage m_image;
+    const QByteArray m_suffix;
+    const QFuture<QByteArray> m_preEncoded;
+    mutable QByteArray m_encoded;
+};
+
 ExportManager::ExportManager(QObject *parent)
     : QObject(parent)
     , m_imageSavedNotInTemp(false)
     , m_saveImage(QImage())
     , m_tempFile(QUrl())
+    , m_qrCodeScanner(std::make_unique<QRCodeScanner>())
 {
+    connect(m_qrCodeScanner.get(), &QRCodeScanner::scanned, this, &ExportManager::qrCodeScanned);
     connect(this, &ExportManager::imageExported, this, [](Actions actions, const QUrl &url) {
         if (actions & AnySave) {
             Settings::setLastImageSaveLocation(url);
@@ -78,6 +133,9 @@ QImage ExportManager::image() const
 
 void ExportManager::setImage(const QImage &image)
 {
+    if (m_preEncoded.cacheKey != image.cacheKey()) {
+        discardPreEncoded();
+    }
     m_saveImage = image;
 
     // reset our saved tempfile
@@ -439,7 +497,7 @@ QImage scaledImageFromSubGeometry(const QImage &image)
                              fastScale ? Qt::FastTransformation : Qt::SmoothTransformation);
 }
 
-bool ExportManager::writeImage(QIODevice *device, const QByteArray &suffix)
+bool ExportManager::encodeImage(const QImage &image, QIODevice *device, const QByteArray &suffix, QString *errorString)
 {
     // In the documentation for QImageWriter, it is a bit ambiguous what "format" means.
     // From looking at how QImageWriter handles the built-in supported formats internally,
@@ -456,12 +514,70 @@ bool ExportManager::writeImage(QIODevice *device, const QByteArray &suffix)
         imageWriter.setCompression(50);
     }
     if (!(imageWriter.canWrite())) {
-        Q_EMIT errorMessage(i18n("QImageWriter cannot write image: %1", imageWriter.errorString()));
+        if (errorString) {
+            *errorString = imageWriter.errorString();
+        }
         return false;
     }
     // Scale image to original scale if possible.
     // This is done here because we need the highest resolution version in the rest of the app.
-    return imageWriter.write(scaledImageFromSubGeometry(m_saveImage));
+    return imageWriter.write(scaledImageFromSubGeometry(image));
+}
+
+void ExportManager::preEncode()
+{
+    preEncode(m_saveImage);
+}
+
+void ExportManager::preEncode(const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+    const auto suffix = Settings::preferredImageFormat().toLower().toLatin1();
+    const int quality = Settings::imageCompressionQuality();
+    if (m_preEncoded.data.isValid() && m_preEncoded.cacheKey == image.cacheKey() //
+        && m_preEncoded.suffix == suffix && m_preEncoded.quality == quality) {
+        return;
+    }
+    m_preEncoded = {image.cacheKey(), suffix, quality, QtConcurrent::run([image, suffix] {
+                        QBuffer buffer;
+                        buffer.open(QIODevice::WriteOnly);
+                        // An empty result means the caller has to encode again and report the error.
+                        return encodeImage(image, &buffer, suffix) ? buffer.data() : QByteArray();
+                    })};
+}
+
+void ExportManager::discardPreEncoded()
+{
+    // A running encode can't be interrupted, but its result is simply dropped.
+    m_preEncoded = {};
+}
+
+QFuture<QByteArray> ExportManager::preEncodedData(const QByteArray &suffix) const
+{
+    if (m_preEncoded.data.isValid() && m_preEncoded.cacheKey == m_saveImage.cacheKey() //
+        && m_preEncoded.suffix == suffix && m_preEncoded.quality == int(Settings::imageCompressionQuality())) {
+        return m_preEncoded.data;
+    }
+    return {};
+}
+
+bool ExportManager::writeImage(QIODevice *device, const QByteArray &suffix)
+{
+    if (const auto preEncoded = preEncodedData(suffix); preEncoded.isValid()) {
+        // Usually done by now. If not, waiting is still faster than starting over.
+        const auto data = preEncoded.result();
+        if (!data.isEmpty()) {
+            return device->write(data) == data.size();
+        }
+    }
+    QString errorString;
+    const bool written = encodeImage(m_saveImage, device, suffix, &errorString);
+    if (!errorString.isEmpty()) {
+        Q_EMIT errorMessage(i18n("QImageWriter cannot write image: %1", errorString));
+    }
+    return written;
 }
 
 bool ExportManager::localSave(const QUrl &url, const QString &suffix)
@@ -583,6 +699,12 @@ bool ExportManager::save(const QUrl &url)
     if (saveSucceded) {
         m_imageSavedNotInTemp = true;
         KRecentDocument::add(url, QGuiApplication::desktopFileName());
+        if (url.isLocalFile()) {
+            ThumbnailCache::writeInBackground(m_saveImage, url.toLocalFile());
+        }
+        if (Settings::indexSavedScreenshots()) {
+            ScreenshotIndex::instance()->add(m_saveImage, url, m_timestamp);
+        }
     }
     return saveSucceded;
 }
@@ -669,25 +791,14 @@ void ExportManager::exportImage(ExportManager::Actions actions, QUrl url)
         if (!url.isValid() && m_imageSavedNotInTemp) {
             url = Settings::self()->lastImageSaveLocation();
         }
-        auto data = new QMimeData();
         auto preferredFormat = Settings::preferredImageFormat().toLower();
         // TODO: Maybe copy a temp file URL instead? That way we could reliably
         // paste as the preferred format without decompression. The issue with
         // that is that some apps like Discord won't copy temp files when in a
         // Flatpak even if you use KUrlMimeData::exportUrlsToPortal().
-        QBuffer buffer;
-        buffer.open(QIODevice::ReadWrite);
-        QImageWriter writer(&buffer, preferredFormat.toLatin1());
-        if (preferredFormat != u"png") {
-            writer.setQuality(Settings::imageCompressionQuality());
-        }
-        // We want to reuse this image to waste less CPU.
+        const auto suffix = preferredFormat.toLatin1();
+        auto data = new LazyImageMimeData(u"image/" + preferredFormat, m_saveImage, suffix, preEncodedData(suffix));
         auto image = scaledImageFromSubGeometry(m_saveImage);
-        writer.write(image);
-        buffer.reset();
-        // Set first so that it gets chosen first.
-        data->setData(u"image/" + preferredFormat, buffer.readAll());
-        buffer.close();
         // Use the standard way to set images to expose all the other formats.
         // We use the uncompressed image because lossy compressed formats will
         // decompress when turned into QImages and become 2-8x larger than their
@@ -708,6 +819,8 @@ void ExportManager::exportImage(ExportManager::Actions actions, QUrl url)
         // "application/x-kde-suggestedfilename" is handled by KIO/PasteJob.
         // It should put a useful default filename in the paste dialog.
         data->setData(u"application/x-kde-suggestedfilename"_s, QFile::encodeName(fileName));
+        m_clipboardImageData = data;
+        connect(data, &QObject::destroyed, this, &ExportManager::clipboardImageReleased);
         KSystemClipboard::instance()->setMimeData(data, QClipboard::Clipboard);
         success = true;
     }
@@ -740,18 +853,19 @@ void ExportManager::exportImage(ExportManager::Actions actions, QUrl url)
     }
 }
 
-void ExportManager::scanQRCode()
+bool ExportManager::ownsClipboardImage() const
 {
-    auto scan = [this] {
-        const auto result = Prison::ImageScanner::scan(ExportManager::instance()->image());
+    return m_clipboardImageData;
+}
 
-        if (result.hasText()) {
-            Q_EMIT qrCodeScanned(result.text());
-        } else if (result.hasBinaryData()) {
-            Q_EMIT qrCodeScanned(result.binaryData());
-        }
-    };
-    auto future = QtConcurrent::run(scan);
+void ExportManager::scanQRCode(quint64 revision)
+{
+    m_qrCodeScanner->scan(m_saveImage, revision);
+}
+
+void ExportManager::cancelQRCodeScan()
+{
+    m_qrCodeScanner->cancel();
 }
 
 void ExportManager::exportVideo(ExportManager::Actions actions, const QUrl &inputUrl, QUrl outputUrl)
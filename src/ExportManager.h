@@ -8,13 +8,17 @@
 #include "settings.h"
 #include <KLocalizedString>
 #include <QDateTime>
+#include <QFuture>
 class QLockFile;
 class QIODevice;
+class QMimeData;
 #include <QMap>
 #include <QObject>
+#include <QPointer>
 class QPrinter;
 #include <QUrl>
 
+class QRCodeScanner;
 class QTemporaryDir;
 
 class ExportManager : public QObject
@@ -116,6 +120,30 @@ public:
 
     static const QList<Placeholder> filenamePlaceholders;
 
+    /**
+     * Encode the image to the device using the format for the file suffix and the
+     * compression settings. Does not touch any state, so it can be used from other threads.
+     */
+    static bool encodeImage(const QImage &image, QIODevice *device, const QByteArray &suffix, QString *errorString = nullptr);
+
+    /**
+     * Start encoding the current image with the preferred format on a worker thread, so that
+     * saving it or handing it to another application later only has to write the result.
+     * Does nothing if the image is already being encoded or has been encoded.
+     */
+    void preEncode();
+
+    /**
+     * Same as above, but for an image that is expected to be set with setImage() later.
+     * Only the latest image is kept.
+     */
+    void preEncode(const QImage &image);
+
+    /**
+     * Drop the result of preEncode(). Call this when the image is about to change.
+     */
+    void discardPreEncoded();
+
     /**
      * Export an image with the given actions using the given URL or an automatically generated URL.
      */
@@ -128,8 +156,21 @@ public:
 
     /**
      * Scan the current image for a QR code.
+     * The current image is only scanned once for each annotation revision.
+     */
+    void scanQRCode(quint64 revision = 0);
+
+    /**
+     * Cancel the scan of the last scanned image and forget its result.
+     * Only needed when the capture is replaced, not when annotations are synced to the current image.
      */
-    void scanQRCode();
+    void cancelQRCodeScan();
+
+    /**
+     * Whether the clipboard still has the data of the last image copied with exportImage().
+     * That data is gone when Spectacle quits unless a clipboard manager took it over.
+     */
+    bool ownsClipboardImage() const;
 
     /**
      * Print the current image with the given printer.
@@ -143,12 +184,15 @@ Q_SIGNALS:
     void imageExported(const ExportManager::Actions &actions, const QUrl &url = {});
     void videoExported(const ExportManager::Actions &actions, const QUrl &url = {});
     void qrCodeScanned(const QVariant &content);
+    // The copied image was replaced on the clipboard, usually by a clipboard manager taking it over.
+    void clipboardImageReleased();
 
 private:
     static QString truncatedFilename(const QString &filename);
     using FileNameAlreadyUsedCheck = bool (ExportManager::*)(const QUrl &) const;
     QString autoIncrementFilename(const QString &baseName, const QString &extension, FileNameAlreadyUsedCheck isFileNameUsed) const;
     QString imageFileSuffix(const QUrl &url) const;
+    QFuture<QByteArray> preEncodedData(const QByteArray &suffix) const;
     bool writeImage(QIODevice *device, const QByteArray &suffix);
     bool save(const QUrl &url);
     bool localSave(const QUrl &url, const QString &suffix);
@@ -162,6 +206,17 @@ private:
     std::unique_ptr<QLockFile> m_tempDirLock;
     std::unique_ptr<QTemporaryDir> m_tempDir;
     QList<QUrl> m_usedTempFileNames;
+
+    struct PreEncoded {
+        qint64 cacheKey = 0;
+        QByteArray suffix;
+        int quality = -1;
+        QFuture<QByteArray> data;
+    };
+    PreEncoded m_preEncoded;
+    std::unique_ptr<QRCodeScanner> m_qrCodeScanner;
+    // Owned by the clipboard, which deletes it when something else is copied.
+    QPointer<QMimeData> m_clipboardImageData;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(ExportManager::Actions)
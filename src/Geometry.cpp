@@ -3,12 +3,11 @@
  */
 
 #include "Geometry.h"
+#include "ScreenLayout.h"
 
 #include <KWindowSystem>
 
 #include <QDebug>
-#include <QGuiApplication>
-#include <QScreen>
 #include <QWindow>
 
 #include <cmath>
@@ -70,12 +69,7 @@ QRectF Geometry::mapFromPlatformRect(const QRectF &rect, qreal dpr)
 
 QRectF Geometry::logicalScreensRect()
 {
-    QRectF rect;
-    const auto &screens = qGuiApp->screens();
-    for (int i = 0; i < screens.size(); ++i) {
-        rect |= Geometry::mapFromPlatformRect(screens[i]->geometry(), qGuiApp->devicePixelRatio());
-    }
-    return rect;
+    return ScreenLayout::instance()->logicalScreensRect();
 }
 
 qreal Geometry::mapToPlatformValue(qreal value, qreal dpr)
@@ -104,12 +98,7 @@ QRectF Geometry::mapToPlatformRect(const QRectF &rect, qreal dpr)
 
 QRectF Geometry::platformUnifiedRect()
 {
-    QRectF rect;
-    const auto &screens = qGuiApp->screens();
-    for (int i = 0; i < screens.size(); ++i) {
-        rect |= screens[i]->geometry();
-    }
-    return rect;
+    return ScreenLayout::instance()->platformUnifiedRect();
 }
 
 QSize Geometry::rawSize(const QSizeF &size, qreal dpr)
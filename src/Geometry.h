@@ -91,6 +91,7 @@ public:
 
     /**
      * This returns the union of all logical screen rects.
+     * Cached by ScreenLayout.
      *
      * NOTE: Not perfectly accurate with some device pixel ratios
      * and resolutions due to QScreen::geometry being a QRect.
@@ -117,6 +118,7 @@ public:
 
     /**
      * This returns the union of all platform screen rects.
+     * Cached by ScreenLayout.
      *
      * NOTE: Not perfectly accurate with some device pixel ratios
      * and resolutions due to QScreen::geometry being a QRect.
@@ -6,9 +6,11 @@
 
 #include "AnnotationDocument.h"
 #include "EffectUtils.h"
+#include "ExportManager.h"
 #include "Geometry.h"
 #include "DebugUtils.h"
 #include "ImageMetaData.h"
+#include "QtCV.h"
 
 #include <QGuiApplication>
 #include <QPainter>
@@ -16,15 +18,27 @@
 #include <QQuickItem>
 #include <QQuickWindow>
 #include <QScreen>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
 #include <memory>
 #include <source_location>
 
 using G = Geometry;
 
+// Bands smaller than this take longer to set up than to paint.
+static constexpr int minimumBandHeight = 256;
+// Regions with fewer device pixels than this are painted on the calling thread. Most interactive
+// repaints are small and waking up the thread pool would only add latency to them.
+static constexpr qint64 minimumBandedArea = 1024 * 1024;
+
+// Enough for over a dozen blur or pixelate effects covering a 4K screen.
+static constexpr qsizetype historyMemoryBudget = 512 * 1024 * 1024;
+
 QImage defaultImage(const QSize &size, qreal dpr)
 {
-    // RGBA is better for use with OpenCV
-    QImage image(size, QImage::Format_RGBA8888_Premultiplied);
+    // Same format as the base image so that painting one on the other doesn't convert.
+    QImage image(size, QtCV::workingFormat);
     image.setDevicePixelRatio(dpr);
     image.fill(Qt::transparent);
     return image;
@@ -96,28 +110,66 @@ void AnnotationDocument::setCanvas(const QRectF &rect, qreal dpr)
     }
     if (sizeChanged || dprChanged) {
         m_imageSize = (rect.size() * dpr).toSize();
-        m_annotationsImage = defaultImage(m_imageSize, dpr);
+        // Made again with the new size by annotationsImage() if there is anything to paint on it.
+        m_annotationsImage = {};
         Q_EMIT imageSizeChanged();
     }
     // Reset cropped image
-    if (!m_baseImage.isNull()) {
-        const auto imageDIRect = deviceIndependentRect(m_baseImage);
+    if (hasBaseImage()) {
+        const auto imageDIRect = baseImageRect();
         if (m_canvasRect.contains(imageDIRect)) {
             m_croppedBaseImage = {};
         } else {
-            const auto imageRect = G::rectScaled(m_canvasRect.intersected(imageDIRect), m_imageDpr).toRect();
-            m_croppedBaseImage = m_baseImage.copy(imageRect);
+            m_croppedBaseImage = baseImageSection(m_canvasRect.intersected(imageDIRect));
         }
     } else if (!m_croppedBaseImage.isNull()) {
         m_croppedBaseImage = {};
     }
+    compactOffCanvasItems();
     // Unconditionally repaint the whole canvas area
     setRepaintRegion();
 }
 
+void AnnotationDocument::compactOffCanvasItems()
+{
+    m_offCanvasItems.clear();
+    if (!hasBaseImage() || m_canvasRect.contains(baseImageRect())) {
+        return;
+    }
+    qsizetype released = 0;
+    for (const auto &item : m_history.undoList()) {
+        if (!item) {
+            continue;
+        }
+        const auto &visual = std::get<Traits::Visual::Opt>(item->traits());
+        if (visual && !visual->rect.intersects(m_canvasRect)) {
+            m_offCanvasItems.insert(item.get());
+            // The history owns the items, so it's fine to modify them through const pointers.
+            released += Traits::clearEffectCache(std::const_pointer_cast<HistoryItem>(item)->traits());
+        }
+    }
+    if (!m_offCanvasItems.isEmpty()) {
+        Log::debug() << "Skipping" << m_offCanvasItems.size() << "items outside of the canvas," << released << "bytes of effect caches released";
+    }
+}
+
+void AnnotationDocument::releaseUncroppedBaseImage()
+{
+    if (!hasBaseImage() || m_canvasRect.contains(baseImageRect())) {
+        return;
+    }
+    const auto source = m_baseImageSource.isNull() ? MultiResolutionImage({m_baseImage}) : m_baseImageSource;
+    // Document coordinates are relative to the top left of the source.
+    m_baseImageSource = source.intersected(m_canvasRect.translated(source.rect().topLeft()));
+    m_baseImage = {};
+    // Only the capture overlays use them and they're gone after the crop.
+    m_baseImageSlices.clear();
+}
+
 void AnnotationDocument::resetCanvas()
 {
-    setCanvas(deviceIndependentRect(m_baseImage), m_baseImage.devicePixelRatio());
+    const auto dpr = m_baseImageSource.isNull() ? m_baseImage.devicePixelRatio() : m_baseImageSource.devicePixelRatio();
+    setCanvas(baseImageRect(), dpr);
 }
 
 QSizeF AnnotationDocument::imageSize() const
@@ -132,23 +184,134 @@ qreal AnnotationDocument::imageDpr() const
 
 QImage AnnotationDocument::baseImage() const
 {
-    return m_baseImage;
+    return combinedBaseImage();
 }
 
 QImage AnnotationDocument::canvasBaseImage() const
 {
-    if (m_baseImage.isNull() || m_croppedBaseImage.isNull()) {
-        return m_baseImage;
+    if (!hasBaseImage() || m_croppedBaseImage.isNull()) {
+        return combinedBaseImage();
     }
     return m_croppedBaseImage;
 }
 
+bool AnnotationDocument::hasBaseImage() const
+{
+    return !m_baseImage.isNull() || !m_baseImageSource.isNull();
+}
+
+qint64 AnnotationDocument::baseImageCacheKey() const
+{
+    return m_baseImage.isNull() ? 0 : m_baseImage.cacheKey();
+}
+
+QRectF AnnotationDocument::baseImageRect() const
+{
+    if (m_baseImageSource.isNull()) {
+        return deviceIndependentRect(m_baseImage);
+    }
+    return {{0, 0}, m_baseImageSource.rect().size()};
+}
+
+const QImage &AnnotationDocument::combinedBaseImage() const
+{
+    if (m_baseImage.isNull() && !m_baseImageSource.isNull()) {
+        m_baseImage = m_baseImageSource.toImage();
+    }
+    return m_baseImage;
+}
+
+QImage AnnotationDocument::baseImageSection(const QRectF &rect) const
+{
+    if (!m_baseImage.isNull()) {
+        return m_baseImage.copy(G::rectScaled(rect, m_imageDpr).toRect());
+    }
+    // Only resample the screens within the section.
+    return m_baseImageSource.image(rect.translated(m_baseImageSource.rect().topLeft()), m_imageDpr);
+}
+
+// Cut the section of one screen out of a combined screenshot, using the sub geometry recorded by
+// the image platform. Screens with a lower device pixel ratio than the combined image are scaled
+// back down to their own DPR. Null if no screen has that aligned rect and DPR.
+static QImage screenSlice(const QImage &image, const QRect &alignedRect, qreal dpr)
+{
+    const auto subGeometryList = ImageMetaData::subGeometryList(image);
+    if (subGeometryList.size() < 2) {
+        return {};
+    }
+    const auto imageDpr = image.devicePixelRatio();
+    const auto imageDIRect = deviceIndependentRect(image);
+    for (const auto &map : subGeometryList) {
+        const auto rect = ImageMetaData::rectFromSubGeometryPropertyMap(map);
+        const auto screenDpr = map.value(ImageMetaData::Keys::SubGeometryProperty::DevicePixelRatio);
+        if (rect.toAlignedRect() != alignedRect || !qFuzzyCompare(screenDpr, dpr) || !imageDIRect.contains(rect)) {
+            continue;
+        }
+        auto slice = image.copy(G::rectScaled(rect, imageDpr).toRect());
+        const auto size = (rect.size() * dpr).toSize();
+        if (slice.size() != size) {
+            // Area interpolation undoes the integer upscaling in MultiResolutionImage::toImage() exactly.
+            auto scaled = QImage(size, slice.format());
+            auto scaledMat = QtCV::qImageToMat(scaled);
+            cv::resize(QtCV::qImageToMat(slice), scaledMat, scaledMat.size(), 0, 0, cv::INTER_AREA);
+            slice = scaled;
+        }
+        slice.setDevicePixelRatio(dpr);
+        return slice;
+    }
+    return {};
+}
+
+QImage AnnotationDocument::baseImageSlice(const QRectF &rect, qreal dpr) const
+{
+    if (!m_canvasRect.contains(rect)) {
+        return {};
+    }
+    // Logical screen rects don't always survive the round trip through the image metadata exactly.
+    const auto alignedRect = rect.toAlignedRect();
+    for (const auto &slice : m_baseImageSlices) {
+        if (slice.rect.toAlignedRect() == alignedRect && qFuzzyCompare(slice.image.devicePixelRatio(), dpr)) {
+            return slice.image;
+        }
+    }
+    if (!m_baseImageSource.isNull() || m_baseImage.isNull()) {
+        // The screen images of a MultiResolutionImage already are all of the slices.
+        return {};
+    }
+    // Only capture overlays ask for a screen that exists, so slices are made when they do.
+    auto image = screenSlice(m_baseImage, alignedRect, dpr);
+    if (!image.isNull()) {
+        m_baseImageSlices.append({rect, image});
+    }
+    return image;
+}
+
 void AnnotationDocument::setBaseImage(const QImage &image)
 {
-    if (m_baseImage.cacheKey() == image.cacheKey()) {
+    if (m_baseImageSource.isNull() && m_baseImage.cacheKey() == image.cacheKey()) {
         return;
     }
+    m_baseImageSource = {};
     m_baseImage = image;
+    m_baseImageSlices.clear();
+    resetCanvas();
+}
+
+void AnnotationDocument::setBaseImage(const MultiResolutionImage &image)
+{
+    const auto &tiles = image.tiles();
+    if (tiles.size() < 2) {
+        setBaseImage(image.toImage());
+        return;
+    }
+    m_baseImageSource = image;
+    m_baseImage = {};
+    // The screen images already are the slices.
+    m_baseImageSlices.clear();
+    const auto origin = image.rect().topLeft();
+    for (const auto &tile : tiles) {
+        m_baseImageSlices.append({tile.rect.translated(-origin), tile.image});
+    }
     resetCanvas();
 }
 
@@ -189,6 +352,8 @@ void AnnotationDocument::cropCanvas(const QRectF &cropRect)
 void AnnotationDocument::clearAnnotations()
 {
     auto result = m_history.clearLists();
+    m_offCanvasItems.clear();
+    m_hasVisibleItems = false;
     m_tool->resetType();
     m_tool->resetNumber();
     deselectItem();
@@ -201,6 +366,42 @@ void AnnotationDocument::clearAnnotations()
     setRepaintRegion(RepaintType::Annotations);
 }
 
+void AnnotationDocument::addComparison(const QImage &heatmap, const QList<QRect> &changedRects)
+{
+    if (!hasBaseImage() || changedRects.isEmpty()) {
+        return;
+    }
+    deselectItem();
+    // One item, so the whole comparison is undone at once. The heatmap is only painted inside
+    // the outlines, but every changed pixel is inside one of them anyway.
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for (const auto &rect : changedRects) {
+        // Outline the changed pixels without covering them.
+        path.addRect(G::rectScaled(QRectF(rect), 1 / m_imageDpr).adjusted(-2, -2, 2, 2));
+    }
+    // Merge overlapping outlines instead of drawing them over each other.
+    path = path.simplified();
+    HistoryItem temp;
+    std::get<Traits::Geometry::Opt>(temp.traits()).emplace(path);
+    std::get<Traits::Interactive::Opt>(temp.traits()).emplace();
+    std::get<Traits::Visual::Opt>(temp.traits()).emplace();
+    if (!heatmap.isNull()) {
+        // The brush texture is in raw pixels, but we paint in device independent coordinates.
+        QBrush brush(heatmap);
+        brush.setTransform(QTransform::fromScale(1 / heatmap.devicePixelRatio(), 1 / heatmap.devicePixelRatio()));
+        std::get<Traits::Fill::Opt>(temp.traits()).emplace(brush);
+    }
+    auto pen = Traits::Stroke::defaultPen();
+    pen.setBrush(Qt::red);
+    pen.setWidthF(2);
+    std::get<Traits::Stroke::Opt>(temp.traits()).emplace(pen);
+    Traits::initOptTuple(temp.traits());
+    auto newItem = std::make_shared<HistoryItem>(std::move(temp));
+    setRepaintRegion(newItem->renderRect());
+    addItem(newItem);
+}
+
 void AnnotationDocument::clear()
 {
     clearAnnotations();
@@ -237,19 +438,7 @@ void AnnotationDocument::paintAnnotations(QPainter *painter, const QRegion &regi
     const auto begin = range->begin();
     const auto end = range->end();
     // Only highlighter needs the base image to be rendered underneath itself to function correctly.
-    const bool hasHighlighter = std::any_of(begin, end, [this, &region](const HistoryItem::const_shared_ptr &item) {
-        const auto &renderedItem = item == m_selectedItemWrapper->selectedItem() ? m_tempItem : item;
-        if (!renderedItem) {
-            return false;
-        }
-        auto &visual = std::get<Traits::Visual::Opt>(renderedItem->traits());
-        if (!visual) {
-            return false;
-        }
-        return std::get<Traits::Highlight::Opt>(renderedItem->traits()).has_value() //
-            && m_history.itemVisible(item) && region.intersects(visual->rect.toAlignedRect());
-    });
-    if (hasHighlighter) {
+    if (hasHighlighter(region, *range)) {
         bool hasDifferentClip = false;
         QRegion oldRegion;
         if (painter->hasClipping()) {
@@ -259,14 +448,14 @@ void AnnotationDocument::paintAnnotations(QPainter *painter, const QRegion &regi
                 painter->setClipRegion(region);
             }
         }
-        paintImageView(painter, m_baseImage);
+        paintImageView(painter, combinedBaseImage());
         if (hasDifferentClip) {
             painter->setClipRegion(oldRegion);
         }
     }
     for (auto it = begin; it != end; ++it) {
         const auto item = *it;
-        if (!m_history.itemVisible(item)) {
+        if (m_offCanvasItems.contains(item.get()) || !m_history.itemVisible(item)) {
             continue;
         }
         // Render the temporary item instead if this item is selected.
@@ -344,30 +533,173 @@ void AnnotationDocument::paintAnnotations(QPainter *painter, const QRegion &regi
     }
 }
 
+bool AnnotationDocument::hasVisibleItems() const
+{
+    return m_hasVisibleItems;
+}
+
+void AnnotationDocument::updateHasVisibleItems()
+{
+    // Items are replaced by their children, which always come after them in the undo list.
+    // Going backwards means every replaced item is known by the time it is reached, and the
+    // latest item usually settles it. Whether an item can be visible doesn't change while it is
+    // being drawn, unlike whether it currently is, so this only needs updating when the list does.
+    QSet<const HistoryItem *> replaced;
+    const auto &undoList = m_history.undoList();
+    m_hasVisibleItems = false;
+    for (auto it = undoList.end(); it != undoList.begin() && !m_hasVisibleItems;) {
+        const auto &item = *--it;
+        if (!item) {
+            continue;
+        }
+        m_hasVisibleItems = !replaced.contains(item.get()) && Traits::canBeVisible(item->traits());
+        if (const auto parent = item->parent().lock()) {
+            replaced.insert(parent.get());
+        }
+    }
+}
+
 QImage AnnotationDocument::annotationsImage()
 {
-    if (m_annotationsImage.isNull()) {
+    // Most screenshots are never annotated, so don't spend memory or a texture upload
+    // on a transparent image the size of the whole canvas until there is something to paint.
+    if (m_imageSize.isEmpty() || !hasVisibleItems()) {
+        m_annotationsImage = {};
+        m_damage.clear();
         return m_annotationsImage;
     }
-    if (!m_repaintRegion.isEmpty()) {
-        QPainter painter(&m_annotationsImage);
-        // canvas rect top left should be (0,0) in annotations image
-        painter.translate(-m_canvasRect.topLeft());
-        // Set clip region to prevent over-painting shadows or semi-transparent annotations near the region.
-        painter.setClipRegion(m_repaintRegion);
-        // Clear mode is needed to actually clear the region.
-        painter.setCompositionMode(QPainter::CompositionMode_Clear);
-        // The painter is clipped to the region, so we can just use eraseRect.
-        painter.eraseRect(m_repaintRegion.boundingRect());
-        // Restore default composition mode.
-        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-        paintAnnotations(&painter, m_repaintRegion);
-        painter.end();
-        m_repaintRegion = {};
+    if (m_annotationsImage.isNull()) {
+        m_annotationsImage = defaultImage(m_imageSize, m_imageDpr);
+        m_damage.reset(m_canvasRect.toAlignedRect());
+    }
+    if (!m_damage.isEmpty()) {
+        const auto stats = m_damage.stats();
+        Log::debug() << "Repainting annotations:" << stats.rectCount << "rects," << stats.area << "of" << stats.boundingArea
+                     << "pixels in the bounding rect";
+        // Each rect only goes through the annotations intersecting it.
+        for (const auto &rect : m_damage.rects()) {
+            // canvas rect top left should be (0,0) in annotations image
+            paintAnnotationsInBands(m_annotationsImage, m_canvasRect.topLeft(), rect, true);
+        }
+        m_damage.clear();
     }
     return m_annotationsImage;
 }
 
+bool AnnotationDocument::hasHighlighter(const QRegion &region, History::SubRange range) const
+{
+    return std::any_of(range.begin(), range.end(), [this, &region](const HistoryItem::const_shared_ptr &item) {
+        const auto &renderedItem = item == m_selectedItemWrapper->selectedItem() ? m_tempItem : item;
+        if (!renderedItem) {
+            return false;
+        }
+        auto &visual = std::get<Traits::Visual::Opt>(renderedItem->traits());
+        if (!visual) {
+            return false;
+        }
+        return std::get<Traits::Highlight::Opt>(renderedItem->traits()).has_value() //
+            && m_history.itemVisible(item) && region.intersects(visual->rect.toAlignedRect());
+    });
+}
+
+void AnnotationDocument::paintAnnotationsInBands(QImage &image, const QPointF &origin, const QRegion &region, bool clear) const
+{
+    if (image.isNull() || region.isEmpty()) {
+        return;
+    }
+    const qreal dpr = image.devicePixelRatio();
+    qint64 regionArea = 0;
+    for (const auto &rect : region) {
+        regionArea += qint64(rect.width()) * rect.height();
+    }
+    const bool banded = regionArea * dpr * dpr >= minimumBandedArea;
+    // Pairs of first and last row + 1 of each band, in device pixels.
+    QList<std::pair<int, int>> bands;
+    const int maxBandCount = banded ? std::min(QThreadPool::globalInstance()->maxThreadCount(), image.height() / minimumBandHeight) : 1;
+    const int bandCount = std::max(1, maxBandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        const int first = qsizetype(image.height()) * i / bandCount;
+        const int last = qsizetype(image.height()) * (i + 1) / bandCount;
+        const QRectF bandRect{origin.x(), origin.y() + first / dpr, image.width() / dpr, (last - first) / dpr};
+        // Skip bands that don't need to be repainted.
+        if (region.intersects(bandRect.toAlignedRect())) {
+            bands.append({first, last});
+        }
+    }
+    if (bands.size() > 1) {
+        prepareEffectCaches(region);
+        // Combine the base image for highlighters before the threads need it.
+        const auto &undoList = m_history.undoList();
+        if (!m_baseImageSource.isNull() && hasHighlighter(region, History::SubRange{undoList})) {
+            combinedBaseImage();
+        }
+    }
+
+    // Detach before the threads start writing to the image.
+    uchar *bits = image.bits();
+    const auto bytesPerLine = image.bytesPerLine();
+    auto paintBand = [&](const std::pair<int, int> &band) {
+        const auto &[first, last] = band;
+        // Only the rows of this band. Painting outside of them is clipped by the image bounds.
+        QImage bandImage(bits + first * bytesPerLine, image.width(), last - first, bytesPerLine, image.format());
+        bandImage.setDevicePixelRatio(dpr);
+        const QRectF bandRect{origin.x(), origin.y() + first / dpr, image.width() / dpr, (last - first) / dpr};
+        QPainter painter(&bandImage);
+        painter.translate(-bandRect.topLeft());
+        // Set clip region to prevent over-painting shadows or semi-transparent annotations near the region.
+        painter.setClipRegion(region);
+        if (clear) {
+            // Clear mode is needed to actually clear the region.
+            painter.setCompositionMode(QPainter::CompositionMode_Clear);
+            // The painter is clipped to the region, so we can just use eraseRect.
+            painter.eraseRect(region.boundingRect());
+            // Restore default composition mode.
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        }
+        // Only the items in this band are painted.
+        paintAnnotations(&painter, region.intersected(bandRect.toAlignedRect()));
+    };
+    if (bands.size() == 1) {
+        paintBand(bands.constFirst());
+    } else if (!bands.isEmpty()) {
+        QtConcurrent::blockingMap(bands, paintBand);
+    }
+}
+
+void AnnotationDocument::prepareEffectCaches(const QRegion &region) const
+{
+    const auto &undoList = m_history.undoList();
+    const auto begin = undoList.begin();
+    const auto end = undoList.end();
+    for (auto it = begin; it != end; ++it) {
+        const auto item = *it;
+        if (!m_history.itemVisible(item)) {
+            continue;
+        }
+        // Same as paintAnnotations.
+        const auto &renderedItem = item == m_selectedItemWrapper->selectedItem() ? m_tempItem : item;
+        if (!renderedItem) {
+            continue;
+        }
+        auto &visual = std::get<Traits::Visual::Opt>(renderedItem->traits());
+        auto &geometry = std::get<Traits::Geometry::Opt>(renderedItem->traits());
+        auto &fill = std::get<Traits::Fill::Opt>(renderedItem->traits());
+        if (!visual || !geometry || !fill || !region.intersects(visual->rect.toAlignedRect())) {
+            continue;
+        }
+        auto untilNow = History::SubRange{begin, it};
+        auto getImage = [this, untilNow] {
+            return rangeImage(untilNow);
+        };
+        const auto &rect = geometry->path.boundingRect();
+        if (fill->index() == Traits::Fill::Blur) {
+            std::get<Traits::Fill::Blur>(*fill).image(getImage, rect, imageDpr());
+        } else if (fill->index() == Traits::Fill::Pixelate) {
+            std::get<Traits::Fill::Pixelate>(*fill).image(getImage, rect, imageDpr());
+        }
+    }
+}
+
 QImage AnnotationDocument::renderToImage()
 {
     auto image = canvasBaseImage();
@@ -378,11 +710,33 @@ QImage AnnotationDocument::renderToImage()
     return image;
 }
 
+QImage AnnotationDocument::renderToImage(const QRectF &cropRect) const
+{
+    // Same as cropCanvas and setCanvas.
+    const auto newCanvasRect = cropRect.translated(m_canvasRect.topLeft()).intersected(m_canvasRect);
+    if (newCanvasRect.isEmpty() || !hasBaseImage()) {
+        return {};
+    }
+    const auto imageDIRect = baseImageRect();
+    auto image = newCanvasRect.contains(imageDIRect) //
+        ? combinedBaseImage()
+        : baseImageSection(newCanvasRect.intersected(imageDIRect));
+    // Painting directly on the image is equivalent to painting on a transparent layer first.
+    paintAnnotationsInBands(image, newCanvasRect.topLeft(), newCanvasRect.toAlignedRect());
+    ImageMetaData::setLogicalXY(image, newCanvasRect.x(), newCanvasRect.y());
+    return image;
+}
+
+quint64 AnnotationDocument::revision() const
+{
+    return m_revision;
+}
+
 QImage AnnotationDocument::rangeImage(History::SubRange range) const
 {
-    auto image = m_baseImage;
+    auto image = combinedBaseImage();
     QPainter p(&image);
-    paintAnnotations(&p, deviceIndependentRect(m_baseImage).toAlignedRect(), range);
+    paintAnnotations(&p, baseImageRect().toAlignedRect(), range);
     p.end();
     return image;
 }
@@ -395,6 +749,7 @@ bool AnnotationDocument::isCurrentItemValid() const
 HistoryItem::shared_ptr AnnotationDocument::popCurrentItem()
 {
     auto result = m_history.pop();
+    updateHasVisibleItems();
     if (result.item) {
         if (result.item == m_selectedItemWrapper->selectedItem().lock()) {
             deselectItem();
@@ -414,7 +769,7 @@ HistoryItem::const_shared_ptr AnnotationDocument::itemAt(const QRectF &rect) con
     // Precisely the first time so that users can get exactly what they click.
     for (auto it = std::ranges::crbegin(undoList); it != std::ranges::crend(undoList); ++it) {
         const auto item = *it;
-        if (m_history.itemVisible(item)) {
+        if (!m_offCanvasItems.contains(item.get()) && m_history.itemVisible(item)) {
             auto &interactive = std::get<Traits::Interactive::Opt>(item->traits());
             if (interactive->path.contains(rect.center())) {
                 return item;
@@ -428,7 +783,7 @@ HistoryItem::const_shared_ptr AnnotationDocument::itemAt(const QRectF &rect) con
     // Forgiving if that failed so that you don't need to be perfect.
     for (auto it = std::ranges::crbegin(undoList); it != std::ranges::crend(undoList); ++it) {
         const auto item = *it;
-        if (m_history.itemVisible(item)) {
+        if (!m_offCanvasItems.contains(item.get()) && m_history.itemVisible(item)) {
             QPainterPath path(rect.topLeft());
             path.addEllipse(rect);
             auto &interactive = std::get<Traits::Interactive::Opt>(item->traits());
@@ -450,6 +805,9 @@ void AnnotationDocument::undo()
 
     auto currentItem = m_history.currentItem();
     auto prevItem = undoCount > 1 ? undoList[undoCount - 2] : nullptr;
+    // Undo first so that the parent of the current item is read back from the history journal
+    // if it was moved there. Before that, the parent has no traits to get a render rect from.
+    m_history.undo();
     setRepaintRegion(currentItem->renderRect());
     if (prevItem) {
         setRepaintRegion(prevItem->renderRect());
@@ -463,7 +821,7 @@ void AnnotationDocument::undo()
         auto parent = currentItem->parent().lock();
         if (parent) {
             setCanvas(Traits::geometryPathBounds(parent->traits()), m_imageDpr);
-        } else if (!m_baseImage.isNull()) {
+        } else if (hasBaseImage()) {
             resetCanvas();
         }
     }
@@ -474,7 +832,7 @@ void AnnotationDocument::undo()
             deselectItem();
         }
     }
-    m_history.undo();
+    updateHasVisibleItems();
 
     Q_EMIT undoStackDepthChanged();
     Q_EMIT redoStackDepthChanged();
@@ -509,6 +867,7 @@ void AnnotationDocument::redo()
         }
     }
     m_history.redo();
+    updateHasVisibleItems();
 
     Q_EMIT undoStackDepthChanged();
     Q_EMIT redoStackDepthChanged();
@@ -528,6 +887,7 @@ void AnnotationDocument::beginItem(const QPointF &point)
     // if the last item was not valid, discard it (for instance a rectangle with 0 size)
     if (!isCurrentItemValid()) {
         auto result = m_history.pop();
+        updateHasVisibleItems();
         if (result.item) {
             setRepaintRegion(result.item->renderRect());
         }
@@ -768,13 +1128,19 @@ void AnnotationDocument::deleteSelectedItem()
 
 void AnnotationDocument::addItem(const HistoryItem::shared_ptr &item)
 {
+    m_offCanvasItems.remove(item.get());
     auto result = m_history.push(item);
+    updateHasVisibleItems();
     if (result.undoListChanged) {
         Q_EMIT undoStackDepthChanged();
     }
     if (result.redoListChanged) {
         Q_EMIT redoStackDepthChanged();
     }
+    m_history.trimMemory(historyMemoryBudget, [] {
+        const auto dir = ExportManager::instance()->temporaryDir();
+        return dir ? dir->path() : QString{};
+    });
 }
 
 void AnnotationDocument::setRepaintRegion(const QRectF &rect, RepaintTypes types)
@@ -785,22 +1151,19 @@ void AnnotationDocument::setRepaintRegion(const QRectF &rect, RepaintTypes types
     }
     // HACK: workaround not always repainting everywhere it should with fractional scaling.
     auto biggerRect = rect.normalized().adjusted(-1, -1, 0, 0).toAlignedRect();
-    /* QRegion has a QRect overload for operator+=, but not for operator|=.
-     *
-     * `region += rect` is not the same as `region = region.united(rect)`. It will try to add the
-     * rect directly instead of making a copy of itself with the rect added.
-     *
-     * QRegion only works with ints, so we need to convert the rect to image coordinates or ensure
-     * The region contains a bit more than the rect with toAlignedRect.
-     * We normalize the rect because operator+= will no-op if `rect.isEmpty()`.
+    /* The damage tracker only works with ints, so we need to ensure it contains a bit more than
+     * the rect with toAlignedRect.
+     * We normalize the rect because DamageTracker::add() will no-op if `rect.isEmpty()`.
      * `QRectF::isEmpty()` is true when the size is 0 or negative.
      */
     if (!m_canvasRect.intersects(biggerRect)) {
         // No point in trying to transform or add to the region if true.
         return;
     }
-    const bool emitRepaintNeeded = m_repaintRegion.isEmpty() || m_lastRepaintTypes != types;
-    m_repaintRegion += biggerRect;
+    ++m_revision;
+    const bool emitRepaintNeeded = m_damage.isEmpty() || m_lastRepaintTypes != types;
+    // Damage outside of the canvas would only make merging look more expensive than it is.
+    m_damage.add(biggerRect & m_canvasRect.toAlignedRect());
     m_lastRepaintTypes = types;
     if (emitRepaintNeeded) {
         Q_EMIT repaintNeeded(m_lastRepaintTypes);
@@ -809,8 +1172,9 @@ void AnnotationDocument::setRepaintRegion(const QRectF &rect, RepaintTypes types
 
 void AnnotationDocument::setRepaintRegion(RepaintTypes types)
 {
-    const bool emitRepaintNeeded = m_repaintRegion.isEmpty() || m_lastRepaintTypes != types;
-    m_repaintRegion = m_canvasRect.toAlignedRect();
+    ++m_revision;
+    const bool emitRepaintNeeded = m_damage.isEmpty() || m_lastRepaintTypes != types;
+    m_damage.reset(m_canvasRect.toAlignedRect());
     m_lastRepaintTypes = types;
     if (emitRepaintNeeded) {
         Q_EMIT repaintNeeded(m_lastRepaintTypes);
@@ -922,6 +1286,7 @@ bool SelectedItemWrapper::commitChanges()
 
     if (!selectedItem->isValid() && selectedItem == m_document->m_history.currentItem()) {
         auto result = m_document->m_history.pop();
+        m_document->updateHasVisibleItems();
         if (result.redoListChanged) {
             Q_EMIT m_document->redoStackDepthChanged();
         }
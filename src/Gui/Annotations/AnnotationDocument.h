@@ -7,13 +7,16 @@
 #pragma once
 
 #include "AnnotationTool.h"
+#include "DamageTracker.h"
 #include "History.h"
+#include "MultiResolutionImage.h"
 
 #include <QColor>
 #include <QFont>
 #include <QImage>
 #include <QMatrix4x4>
 #include <QObject>
+#include <QSet>
 #include <QVariant>
 #include <qqmlregistration.h>
 
@@ -81,19 +84,49 @@ public:
     /// Image device pixel ratio
     qreal imageDpr() const;
 
+    // Combines the screens of a MultiResolutionImage if it hasn't been done yet.
+    // Use hasBaseImage() to check if there is one.
     QImage baseImage() const;
+    bool hasBaseImage() const;
+    // The cache key of the combined base image or 0 if it hasn't been combined yet.
+    // Identifies the image returned by baseImage() without combining it.
+    qint64 baseImageCacheKey() const;
     // Get the base image section for the current canvas rect.
     QImage canvasBaseImage() const;
+    // Get the base image section for one of the screens the base image was combined from,
+    // at that screen's own device pixel ratio. Null if `rect` isn't the logical rect of such a
+    // screen within the current canvas rect or the screen doesn't use `dpr`.
+    QImage baseImageSlice(const QRectF &rect, qreal dpr) const;
+    struct BaseImageSlice {
+        // Logical rect of the screen in document coordinates.
+        QRectF rect;
+        QImage image;
+    };
     /// Set the base image. Based on the base image, also set image size, image device pixel ratio
     // and canvas rect. Cannot be undone.
     void setBaseImage(const QImage &image);
+    // Same as above, but the screens are only combined into one image at the highest DPR when
+    // something needs all of them at once. Sections and per screen slices are made from the
+    // screen images directly.
+    void setBaseImage(const MultiResolutionImage &image);
 
     /// Hide annotations that do not intersect with the rectangle and crop the image.
     Q_INVOKABLE void cropCanvas(const QRectF &cropRect);
 
+    /// Release the base image outside of the canvas rect after a crop.
+    /// Only for when the crop can't be undone anymore, such as when there is no editor to undo it
+    /// with. The base image would be transparent outside of the canvas rect if it was undone.
+    void releaseUncroppedBaseImage();
+
     /// Clear all annotations. Cannot be undone.
     void clearAnnotations();
 
+    /// Add a heatmap of the differences to another image and outlines around changed regions
+    /// as a single item that is undone at once.
+    /// The heatmap should use the same size and device pixel ratio as the base image.
+    /// The rectangles should use raw pixel coordinates of the base image.
+    void addComparison(const QImage &heatmap, const QList<QRect> &changedRects);
+
     /// Clear all annotations and the image. Cannot be undone.
     void clear();
 
@@ -102,10 +135,17 @@ public:
 
     // Get an image containing just the annotations.
     // This is lazily computed based on an internal paint region of areas needing to be repainted.
+    // Null when there are no visible annotations. The image is only allocated while there are.
     QImage annotationsImage();
 
     QImage renderToImage();
 
+    // Render the image as it would be after cropCanvas(cropRect) without changing the document.
+    QImage renderToImage(const QRectF &cropRect) const;
+
+    // Incremented whenever anything visible changes. Renders of the same revision are identical.
+    quint64 revision() const;
+
     // True when there is an item at the end of the undo stack and it is invalid.
     bool isCurrentItemValid() const;
 
@@ -147,9 +187,41 @@ private:
     // If the span is not set, all annotations intersecting the region will be painted.
     void paintAnnotations(QPainter *painter, const QRegion &imageRegion, std::optional<History::SubRange> range = std::nullopt) const;
 
+    // Paint the annotations intersecting the region onto an image of the document area starting at
+    // `origin`. Large regions are split into horizontal bands that are painted on worker threads,
+    // each with its own painter writing to its own rows of the image. Small regions, like most
+    // repaints while annotating, are painted on the calling thread.
+    // If `clear` is true, the region is cleared before painting.
+    void paintAnnotationsInBands(QImage &image, const QPointF &origin, const QRegion &imageRegion, bool clear = false) const;
+
+    // Generate the image effect caches of the items intersecting the region ahead of time so that
+    // painting the items from several threads only reads them.
+    void prepareEffectCaches(const QRegion &imageRegion) const;
+
     // Get an image that only uses a part of the history.
     QImage rangeImage(History::SubRange range) const;
 
+    // Whether any item that paints something is visible.
+    bool hasVisibleItems() const;
+    // Call whenever items are added to or removed from the undo list.
+    void updateHasVisibleItems();
+
+    // Whether any highlighter intersecting the region is visible. Highlighters need the base image.
+    bool hasHighlighter(const QRegion &imageRegion, History::SubRange range) const;
+
+    // Skip items entirely outside of the canvas rect when painting or looking for items and release
+    // their effect caches. They stay in the history, so undoing a crop brings them back.
+    void compactOffCanvasItems();
+
+    // The device independent rect of the base image in document coordinates.
+    QRectF baseImageRect() const;
+    // The base image with all screens combined. Made on first use from m_baseImageSource.
+    // Not thread safe the first time.
+    const QImage &combinedBaseImage() const;
+    // A new image of the section of the base image at m_imageDpr.
+    // Takes a rectangle with document coordinates.
+    QImage baseImageSection(const QRectF &rect) const;
+
     void addItem(const HistoryItem::shared_ptr &item);
 
     // Repaint if rect size is more than 0x0 and intersects with the canvas.
@@ -168,23 +240,33 @@ private:
     qreal m_imageDpr = 1;
     // An image size based on the canvas size and device pixel ratio.
     QSize m_imageSize{0, 0};
-    // The base screenshot image
-    QImage m_baseImage;
+    // The screen images the base image is made from, if it was set with a MultiResolutionImage.
+    MultiResolutionImage m_baseImageSource;
+    // The base screenshot image. Lazily combined from m_baseImageSource if that is set.
+    mutable QImage m_baseImage;
     // A cache for a crop of the base image.
     QImage m_croppedBaseImage;
+    // Sections of the base image for each screen it was combined from,
+    // at each screen's device pixel ratio. Made on first use if the base image is a QImage.
+    mutable QList<BaseImageSlice> m_baseImageSlices;
     // An image containing just the annotations.
     // It is separate so that we don't need to keep repainting the image underneath.
     QImage m_annotationsImage;
     // The last types of things to repaint. Used to determine when to emit repaintNeeded.
     RepaintTypes m_lastRepaintTypes = RepaintType::NoTypes;
     // Where a repaint is needed. Used to determine when to repaint or emit repaintNeeded.
-    QRegion m_repaintRegion;
+    DamageTracker m_damage;
+    quint64 m_revision = 0;
 
     // A temporary version of the item we want to edit so we can modify at will. This will be used
     // instead of the original item when rendering, but the original item will remain in history
     // until the changes are committed.
     HistoryItem::shared_ptr m_tempItem;
     History m_history;
+    // Items in the undo list that are entirely outside of the canvas rect.
+    // New items are removed from it in case they reuse the address of a deleted item.
+    QSet<const HistoryItem *> m_offCanvasItems;
+    bool m_hasVisibleItems = false;
 };
 
 /**
@@ -22,18 +22,16 @@ static bool s_isAnyPressed = false;
 class AnnotationViewportNode : public QSGNode
 {
     QSGImageNode *m_baseImageNode;
-    QSGImageNode *m_annotationsNode;
+    // Only exists while the document has annotations.
+    QSGImageNode *m_annotationsNode = nullptr;
 
 public:
-    AnnotationViewportNode(QSGImageNode *baseImageNode, QSGImageNode *annotationsNode)
+    AnnotationViewportNode(QSGImageNode *baseImageNode)
         : QSGNode()
         , m_baseImageNode(baseImageNode)
-        , m_annotationsNode(annotationsNode)
     {
         baseImageNode->setOwnsTexture(true);
         appendChildNode(baseImageNode);
-        annotationsNode->setOwnsTexture(true);
-        appendChildNode(annotationsNode);
     }
     QSGImageNode *baseImageNode() const
     {
@@ -43,6 +41,21 @@ public:
     {
         return m_annotationsNode;
     }
+    void setAnnotationsNode(QSGImageNode *annotationsNode)
+    {
+        if (m_annotationsNode == annotationsNode) {
+            return;
+        }
+        if (m_annotationsNode) {
+            removeChildNode(m_annotationsNode);
+            delete m_annotationsNode;
+        }
+        m_annotationsNode = annotationsNode;
+        if (annotationsNode) {
+            annotationsNode->setOwnsTexture(true);
+            appendChildNode(annotationsNode);
+        }
+    }
 };
 
 AnnotationViewport::AnnotationViewport(QQuickItem *parent)
@@ -435,14 +448,12 @@ QSGNode *AnnotationViewport::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
     const auto window = this->window();
     auto node = static_cast<AnnotationViewportNode *>(oldNode);
     if (!node) {
-        node = new AnnotationViewportNode(window->createImageNode(), //
-                                            window->createImageNode());
+        node = new AnnotationViewportNode(window->createImageNode());
         node->baseImageNode()->setFiltering(QSGTexture::Linear);
-        node->annotationsNode()->setFiltering(QSGTexture::Linear);
         // Setting the mipmap filter type also enables mipmaps.
         // Super useful for scaling down smoothly.
         node->baseImageNode()->setMipmapFiltering(QSGTexture::Linear);
-        node->annotationsNode()->setMipmapFiltering(QSGTexture::Linear);
+        m_repaintAnnotations = true;
     }
 
     const auto imageDpr = m_document->imageDpr();
@@ -466,13 +477,25 @@ QSGNode *AnnotationViewport::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
 
     auto baseImageNode = node->baseImageNode();
     if (!baseImageNode->texture() || m_repaintBaseImage) {
-        baseImageNode->setTexture(window->createTextureFromImage(getImage(m_document->canvasBaseImage())));
+        // Capture overlays show exactly one screen, which the document already has at the screen's DPR.
+        const auto slice = m_document->baseImageSlice(canvasView, windowDpr);
+        baseImageNode->setTexture(window->createTextureFromImage(slice.isNull() ? getImage(m_document->canvasBaseImage()) : slice));
         m_repaintBaseImage = false;
     }
 
-    auto annotationsNode = node->annotationsNode();
-    if (!annotationsNode->texture() || m_repaintAnnotations) {
-        annotationsNode->setTexture(window->createTextureFromImage(getImage(m_document->annotationsImage())));
+    if (m_repaintAnnotations) {
+        const auto annotationsImage = m_document->annotationsImage();
+        if (annotationsImage.isNull()) {
+            node->setAnnotationsNode(nullptr);
+        } else {
+            if (!node->annotationsNode()) {
+                auto annotationsNode = window->createImageNode();
+                annotationsNode->setFiltering(QSGTexture::Linear);
+                annotationsNode->setMipmapFiltering(QSGTexture::Linear);
+                node->setAnnotationsNode(annotationsNode);
+            }
+            node->annotationsNode()->setTexture(window->createTextureFromImage(getImage(annotationsImage)));
+        }
         m_repaintAnnotations = false;
     }
 
@@ -486,7 +509,9 @@ QSGNode *AnnotationViewport::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
     };
 
     setupImageNode(baseImageNode);
-    setupImageNode(annotationsNode);
+    if (auto annotationsNode = node->annotationsNode()) {
+        setupImageNode(annotationsNode);
+    }
 
     return node;
 }
@@ -0,0 +1,111 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "DamageTracker.h"
+
+#include <limits>
+
+bool DamageTracker::isEmpty() const
+{
+    return m_rects.isEmpty();
+}
+
+const QList<QRect> &DamageTracker::rects() const
+{
+    return m_rects;
+}
+
+QRect DamageTracker::boundingRect() const
+{
+    QRect result;
+    for (const auto &rect : m_rects) {
+        result |= rect;
+    }
+    return result;
+}
+
+qint64 DamageTracker::area() const
+{
+    qint64 result = 0;
+    for (const auto &rect : m_rects) {
+        result += area(rect);
+    }
+    return result;
+}
+
+qint64 DamageTracker::area(const QRect &rect)
+{
+    return qint64(rect.width()) * rect.height();
+}
+
+qint64 DamageTracker::mergeCost(const QRect &lhs, const QRect &rhs)
+{
+    return area(lhs | rhs) - area(lhs) - area(rhs) + area(lhs & rhs);
+}
+
+void DamageTracker::add(const QRect &rect)
+{
+    if (rect.isEmpty()) {
+        return;
+    }
+    auto pending = rect;
+    // Merging can make the pending rect intersect or be worth merging with rects that were checked
+    // before, so keep going until nothing else gets merged.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = m_rects.begin(); it != m_rects.end();) {
+            if (it->contains(pending)) {
+                return;
+            }
+            // Rects have to stay disjoint so that nothing is repainted twice.
+            if (pending.intersects(*it) || mergeCost(pending, *it) <= perRectCost) {
+                pending |= *it;
+                it = m_rects.erase(it);
+                merged = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+    m_rects.append(pending);
+
+    while (m_rects.size() > maxRectCount) {
+        // Merge the pair that adds the least area. The list is short, so checking every pair is fine.
+        qint64 cheapestCost = std::numeric_limits<qint64>::max();
+        qsizetype first = 0;
+        qsizetype second = 1;
+        for (qsizetype i = 0; i < m_rects.size(); ++i) {
+            for (qsizetype j = i + 1; j < m_rects.size(); ++j) {
+                const auto cost = mergeCost(m_rects[i], m_rects[j]);
+                if (cost < cheapestCost) {
+                    cheapestCost = cost;
+                    first = i;
+                    second = j;
+                }
+            }
+        }
+        const auto mergedRect = m_rects[first] | m_rects[second];
+        m_rects.removeAt(second);
+        m_rects.removeAt(first);
+        // Adding again keeps the rects disjoint if the merged rect now intersects others.
+        add(mergedRect);
+    }
+}
+
+void DamageTracker::reset(const QRect &rect)
+{
+    m_rects.clear();
+    add(rect);
+}
+
+void DamageTracker::clear()
+{
+    m_rects.clear();
+}
+
+DamageTracker::Stats DamageTracker::stats() const
+{
+    return {m_rects.size(), area(), area(boundingRect())};
+}
@@ -0,0 +1,61 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRect>
+
+/**
+ * Keeps track of the areas of an image that need to be repainted as a small list of disjoint rects.
+ *
+ * Repainting the bounding rect of everything that changed means a stroke in one corner and a hover
+ * outline in the opposite corner repaint nearly the whole image. Repainting every changed rect on
+ * its own has a cost of its own for every rect, so rects are merged when the area a merge would
+ * add is cheaper than repainting another rect. There are never more than maxRectCount rects.
+ */
+class DamageTracker
+{
+public:
+    struct Stats {
+        // The number of rects repainted.
+        qsizetype rectCount = 0;
+        // The area repainted in pixels.
+        qint64 area = 0;
+        // The area that repainting the bounding rect would have repainted.
+        qint64 boundingArea = 0;
+    };
+
+    static constexpr qsizetype maxRectCount = 8;
+    // The extra area that is cheaper to repaint than starting another painter and going through
+    // every annotation again for another rect, in pixels.
+    static constexpr qint64 perRectCost = 64 * 64;
+
+    bool isEmpty() const;
+
+    // Disjoint rects covering everything that was added since the last clear().
+    const QList<QRect> &rects() const;
+
+    QRect boundingRect() const;
+
+    // The combined area of rects().
+    qint64 area() const;
+
+    void add(const QRect &rect);
+
+    // Replace everything with just `rect`.
+    void reset(const QRect &rect);
+
+    void clear();
+
+    // The rect count and area of the current rects.
+    Stats stats() const;
+
+private:
+    static qint64 area(const QRect &rect);
+    // The area that merging `lhs` and `rhs` adds to what would be repainted anyway.
+    static qint64 mergeCost(const QRect &lhs, const QRect &rhs);
+
+    QList<QRect> m_rects;
+};
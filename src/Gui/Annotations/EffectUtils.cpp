@@ -11,85 +11,6 @@
 #include <QPainter>
 #include <QtMath>
 
-// TODO: switch to this slightly more high quality one (or even gaussian blur) when live editing is over?
-QImage boxBlur(const QImage &src, int radius)
-{
-    QImage blurX = (src.format() != QImage::Format_ARGB32_Premultiplied) ? src.convertToFormat(QImage::Format_ARGB32_Premultiplied) : src;
-
-    int count = 0;
-    int r = 0;
-    int g = 0;
-    int b = 0;
-    int a = 0;
-    QRgb rgb;
-    for (int i = 0; i < blurX.height(); ++i) {
-        for (int j = 0; j < blurX.width(); ++j) {
-            count = 0;
-            r = 0;
-            g = 0;
-            b = 0;
-            a = 0;
-            for (int k = qMax(0, j - radius); k < qMin(blurX.width(), j + radius); ++k) {
-                rgb = src.pixel(k, i);
-                r += qRed(rgb);
-                g += qGreen(rgb);
-                b += qBlue(rgb);
-                a += qAlpha(rgb);
-                ++count;
-            }
-            blurX.setPixel(j, i, qRgba(r / count, g / count, b / count, a / count));
-        }
-    }
-    // QImage blurY = blurX;
-    for (int i = 0; i < blurX.width(); ++i) {
-        for (int j = 0; j < blurX.height(); ++j) {
-            count = 0;
-            r = 0;
-            g = 0;
-            b = 0;
-            a = 0;
-            for (int k = qMax(0, j - radius); k < qMin(blurX.height(), j + radius); ++k) {
-                rgb = blurX.pixel(i, k);
-                r += qRed(rgb);
-                g += qGreen(rgb);
-                b += qBlue(rgb);
-                a += qAlpha(rgb);
-                ++count;
-            }
-            blurX.setPixel(i, j, qRgba(r / count, g / count, b / count, a / count));
-        }
-    }
-    return blurX;
-}
-
-/**
- * This thing kinda looks like a box blur, but is limited at painting over with qpainter opacity rather than proper color mixing
- * It looks a bit worse than proper box blur but is much faster
- */
-QImage fastPseudoBlur(const QImage &src, int radius, qreal devicePixelRatio)
-{
-    QImage out = (src.format() != QImage::Format_ARGB32_Premultiplied) ? src.convertToFormat(QImage::Format_ARGB32_Premultiplied) : src;
-    QImage out2 = (src.format() != QImage::Format_ARGB32_Premultiplied) ? src.convertToFormat(QImage::Format_ARGB32_Premultiplied) : src;
-
-    QPainter p(&out);
-    p.setOpacity(1.0 / radius);
-    for (int i = -radius; i < 0; ++i) {
-        p.drawImage(QPointF(i / devicePixelRatio, 0), src);
-        p.drawImage(QPointF(-i / devicePixelRatio, 0), src);
-    }
-    p.end();
-
-    p.begin(&out2);
-    p.setOpacity(1.0 / radius);
-    for (int i = -radius; i < 0; ++i) {
-        p.drawImage(QPointF(0, i / devicePixelRatio), out);
-        p.drawImage(QPointF(0, -i / devicePixelRatio), out);
-    }
-    p.end();
-
-    return out2;
-}
-
 QImage shapeShadow(const Traits::OptTuple &traits, qreal devicePixelRatio)
 {
     auto &shadowTrait = std::get<Traits::Shadow::Opt>(traits);
@@ -99,7 +20,7 @@ QImage shapeShadow(const Traits::OptTuple &traits, qreal devicePixelRatio)
 
     auto &geometryTrait = std::get<Traits::Geometry::Opt>(traits);
     auto &visualTrait = std::get<Traits::Visual::Opt>(traits);
-    QImage shadow(visualTrait->rect.size().toSize() * devicePixelRatio, QImage::Format_RGBA8888_Premultiplied);
+    QImage shadow(visualTrait->rect.size().toSize() * devicePixelRatio, QtCV::workingFormat);
     shadow.fill(Qt::transparent);
     QPainter p(&shadow);
     p.setRenderHint(QPainter::Antialiasing);
@@ -15,6 +15,4 @@ static const int shadowBlurRadius = 2;
 static const int shadowOffsetX = 2;
 static const int shadowOffsetY = 2;
 
-QImage boxBlur(const QImage &src, int radius);
-QImage fastPseudoBlur(const QImage &src, int radius, qreal devicePixelRatio = 1);
 QImage shapeShadow(const Traits::OptTuple &traits, qreal devicePixelRatio = 1);
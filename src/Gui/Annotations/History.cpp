@@ -3,11 +3,18 @@
  */
 
 #include "History.h"
+#include "DebugUtils.h"
+#include <QDataStream>
 #include <QDebug>
+#include <QTemporaryFile>
 #include <ranges>
 
 using namespace Qt::StringLiterals;
 
+// The newest undo items are likely to be undone soon, so they're never moved to the journal.
+static constexpr History::List::size_type minimumResidentItems = 16;
+static constexpr auto journalStreamVersion = QDataStream::Qt_6_0;
+
 bool HistoryItem::hasParent() const
 {
     return m_parent && !m_parent->expired();
@@ -150,6 +157,150 @@ History::List::size_type eraseInvalidItems(History::List &list, It first, It las
     return removedCount;
 }
 
+//--- Journal serialization. Effect caches aren't written since they can be regenerated.
+
+static void writeTrait(QDataStream &stream, const Traits::Geometry &trait)
+{
+    stream << trait.path;
+}
+static void readTrait(QDataStream &stream, Traits::Geometry &trait)
+{
+    stream >> trait.path;
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Interactive &trait)
+{
+    stream << trait.path;
+}
+static void readTrait(QDataStream &stream, Traits::Interactive &trait)
+{
+    stream >> trait.path;
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Visual &trait)
+{
+    stream << trait.rect;
+}
+static void readTrait(QDataStream &stream, Traits::Visual &trait)
+{
+    stream >> trait.rect;
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Stroke &trait)
+{
+    stream << trait.pen << trait.path;
+}
+static void readTrait(QDataStream &stream, Traits::Stroke &trait)
+{
+    stream >> trait.pen >> trait.path;
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Fill &trait)
+{
+    stream << quint8(trait.index());
+    if (trait.index() == Traits::Fill::Brush) {
+        stream << std::get<Traits::Fill::Brush>(trait);
+    } else if (trait.index() == Traits::Fill::Blur) {
+        stream << std::get<Traits::Fill::Blur>(trait).strength();
+    } else if (trait.index() == Traits::Fill::Pixelate) {
+        stream << std::get<Traits::Fill::Pixelate>(trait).strength();
+    }
+}
+static void readTrait(QDataStream &stream, Traits::Fill &trait)
+{
+    quint8 index = 0;
+    stream >> index;
+    if (index == Traits::Fill::Brush) {
+        QBrush brush;
+        stream >> brush;
+        trait.emplace<Traits::Fill::Brush>(brush);
+    } else if (index == Traits::Fill::Blur || index == Traits::Fill::Pixelate) {
+        qreal strength = 0;
+        stream >> strength;
+        if (index == Traits::Fill::Blur) {
+            trait.emplace<Traits::Fill::Blur>(strength);
+        } else {
+            trait.emplace<Traits::Fill::Pixelate>(strength);
+        }
+    } else {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Text &trait)
+{
+    stream << quint8(trait.index());
+    if (trait.index() == Traits::Text::String) {
+        stream << std::get<Traits::Text::String>(trait);
+    } else if (trait.index() == Traits::Text::Number) {
+        stream << qint32(std::get<Traits::Text::Number>(trait));
+    }
+    stream << trait.brush << trait.font;
+}
+static void readTrait(QDataStream &stream, Traits::Text &trait)
+{
+    quint8 index = 0;
+    stream >> index;
+    if (index == Traits::Text::String) {
+        QString string;
+        stream >> string;
+        trait.emplace<Traits::Text::String>(string);
+    } else if (index == Traits::Text::Number) {
+        qint32 number = 0;
+        stream >> number;
+        trait.emplace<Traits::Text::Number>(number);
+    } else {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    stream >> trait.brush >> trait.font;
+}
+
+static void writeTrait(QDataStream &stream, const Traits::Shadow &trait)
+{
+    stream << trait.enabled;
+}
+static void readTrait(QDataStream &stream, Traits::Shadow &trait)
+{
+    stream >> trait.enabled;
+}
+
+// Traits without data only need to be present.
+template<typename T>
+static void writeTrait(QDataStream &, const T &)
+{
+}
+template<typename T>
+static void readTrait(QDataStream &, T &)
+{
+}
+
+static QDataStream &operator<<(QDataStream &stream, const Traits::OptTuple &traits)
+{
+    std::apply(
+        [&stream](const auto &...opts) {
+            ((stream << opts.has_value(), opts ? writeTrait(stream, *opts) : void()), ...);
+        },
+        traits);
+    return stream;
+}
+
+static QDataStream &operator>>(QDataStream &stream, Traits::OptTuple &traits)
+{
+    std::apply(
+        [&stream](auto &...opts) {
+            auto read = [&stream](auto &opt) {
+                bool hasValue = false;
+                stream >> hasValue;
+                if (hasValue) {
+                    readTrait(stream, opt.emplace());
+                }
+            };
+            (read(opts), ...);
+        },
+        traits);
+    return stream;
+}
+
 //---
 
 History::History(const List &undoList, const List &redoList)
@@ -226,6 +377,10 @@ History::ItemReplacedResult History::pop()
     }
     auto item = std::move(m_undoList.back());
     m_undoList.erase(m_undoList.cend() - 1);
+    // The parent becomes visible again.
+    if (item) {
+        restore(item->parent());
+    }
     return {item, eraseInvalidRedoItems()};
 }
 
@@ -236,6 +391,10 @@ bool History::undo()
     }
     m_redoList.push_back(std::move(m_undoList.back()));
     m_undoList.erase(m_undoList.cend() - 1);
+    // The parent becomes visible again.
+    if (const auto &item = m_redoList.back()) {
+        restore(item->parent());
+    }
     return true;
 }
 
@@ -275,7 +434,10 @@ bool History::clearUndoList()
 
 History::ListsChangedResult History::clearLists()
 {
-    return {clearUndoList(), clearRedoList()};
+    ListsChangedResult result{clearUndoList(), clearRedoList()};
+    // Nothing can be restored from it anymore.
+    m_journal.reset();
+    return result;
 }
 
 bool History::itemVisible(const HistoryItem::const_shared_ptr &item) const
@@ -289,6 +451,117 @@ bool History::itemVisible(const HistoryItem::const_shared_ptr &item) const
     return !child || std::find(m_undoList.crbegin(), m_undoList.crend(), child) == m_undoList.crend();
 }
 
+qsizetype History::memoryCost() const
+{
+    qsizetype cost = 0;
+    for (const auto &list : {std::cref(m_undoList), std::cref(m_redoList)}) {
+        for (const auto &item : list.get()) {
+            if (item) {
+                cost += sizeof(HistoryItem) + Traits::memoryCost(item->m_traits);
+            }
+        }
+    }
+    return cost;
+}
+
+void History::trimMemory(qsizetype budget, const std::function<QString()> &journalDirectory)
+{
+    auto cost = memoryCost();
+    if (cost <= budget) {
+        return;
+    }
+    // Caches of items in the redo list aren't used until they're redone.
+    // Redo items are in reverse chronological order, so the furthest from the current state is first.
+    for (auto it = m_redoList.cbegin(); it != m_redoList.cend() && cost > budget; ++it) {
+        if (*it) {
+            cost -= Traits::clearEffectCache((*it)->m_traits);
+        }
+    }
+    for (auto it = m_undoList.cbegin(); it != m_undoList.cend() && cost > budget; ++it) {
+        if (*it && !itemVisible(*it)) {
+            cost -= Traits::clearEffectCache((*it)->m_traits);
+        }
+    }
+    if (cost <= budget || m_undoList.size() <= minimumResidentItems) {
+        return;
+    }
+    // The parent of the current item is needed as soon as the current item is undone.
+    const auto current = currentItem();
+    const auto currentParent = current ? current->parent().lock() : nullptr;
+    const auto end = m_undoList.cend() - minimumResidentItems;
+    for (auto it = m_undoList.cbegin(); it != end && cost > budget; ++it) {
+        const auto &item = *it;
+        if (!item || item->m_journalOffset || item == currentParent || itemVisible(item)) {
+            continue;
+        }
+        // Meta items are tiny, but other code searches the undo list for them.
+        const auto &traits = item->m_traits;
+        if (std::get<Traits::Meta::Crop::Opt>(traits) || std::get<Traits::Meta::Delete::Opt>(traits)) {
+            continue;
+        }
+        const auto released = spill(item, journalDirectory);
+        if (released == 0) {
+            return;
+        }
+        cost -= released;
+    }
+}
+
+qsizetype History::spill(const HistoryItem::shared_ptr &item, const std::function<QString()> &journalDirectory)
+{
+    if (!m_journal) {
+        const auto directory = journalDirectory ? journalDirectory() : QString{};
+        if (directory.isEmpty()) {
+            return 0;
+        }
+        auto journal = std::make_shared<QTemporaryFile>(directory + u"/history-XXXXXX.journal"_s);
+        if (!journal->open()) {
+            Log::warning() << "Cannot create the history journal" << journal->errorString();
+            return 0;
+        }
+        m_journal = journal;
+    }
+    const auto offset = m_journal->size();
+    m_journal->seek(offset);
+    QDataStream stream(m_journal.get());
+    stream.setVersion(journalStreamVersion);
+    stream << item->m_traits;
+    if (stream.status() != QDataStream::Ok) {
+        Log::warning() << "Cannot write to the history journal" << m_journal->errorString();
+        m_journal->resize(offset);
+        return 0;
+    }
+    const auto released = Traits::memoryCost(item->m_traits) - Traits::memoryCost({});
+    item->m_traits = {};
+    item->m_journalOffset = offset;
+    return released;
+}
+
+void History::restore(const HistoryItem::const_weak_ptr &weakItem)
+{
+    // The items are owned by the history, so it's fine to modify them even if we only get const
+    // pointers from the relations between items.
+    const auto item = std::const_pointer_cast<HistoryItem>(weakItem.lock());
+    if (!item || !item->m_journalOffset) {
+        return;
+    }
+    const auto offset = *item->m_journalOffset;
+    item->m_journalOffset.reset();
+    if (!m_journal || !m_journal->seek(offset)) {
+        Log::warning() << "Cannot restore a history item from the journal";
+        return;
+    }
+    QDataStream stream(m_journal.get());
+    stream.setVersion(journalStreamVersion);
+    Traits::OptTuple traits;
+    stream >> traits;
+    if (stream.status() != QDataStream::Ok) {
+        Log::warning() << "Cannot restore a history item from the journal";
+        return;
+    }
+    item->m_traits = std::move(traits);
+}
+
 bool History::eraseInvalidRedoItems()
 {
     // Erase in chronological order so that later item Parent traits become invalidated.
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "Traits.h"
+#include <QFile>
+#include <functional>
 #include <ranges>
 
 class HistoryItem;
@@ -114,6 +116,8 @@ protected:
     mutable std::optional<HistoryItem::const_weak_ptr> m_parent;
     mutable HistoryItem::const_weak_ptr m_child;
     Traits::OptTuple m_traits;
+    // Where the traits were written in the history journal while they're not in memory.
+    std::optional<qint64> m_journalOffset;
 };
 
 QDebug operator<<(QDebug debug, const HistoryItem &item);
@@ -196,14 +200,30 @@ public:
     // Whether the item is visible, in the undo list and without a child also in the undo list.
     bool itemVisible(const HistoryItem::const_shared_ptr &item) const;
 
+    // Estimate of the memory used by all items in bytes.
+    qsizetype memoryCost() const;
+
+    // Reduce the memory used by items that can't be seen until it's within `budget` bytes.
+    // Image effect caches are released first, starting with the items furthest from the current
+    // state. If that isn't enough, the traits of the oldest hidden undo items are moved to a journal
+    // file in the directory returned by `journalDirectory`. They're read back when undo makes
+    // those items visible again, so this is invisible to users of the history.
+    void trimMemory(qsizetype budget, const std::function<QString()> &journalDirectory);
+
 protected:
     friend QDebug operator<<(QDebug debug, const History &history);
     // These are not public because we need to manage the child and parent traits of each item.
     bool clearUndoList();
     bool eraseInvalidRedoItems();
+    // Move the traits of the item to the journal. Returns the number of bytes released.
+    qsizetype spill(const HistoryItem::shared_ptr &item, const std::function<QString()> &journalDirectory);
+    // Read the traits of the item back from the journal if they were moved there.
+    void restore(const HistoryItem::const_weak_ptr &item);
 
     List m_undoList;
     List m_redoList;
+    // Shared by copies of the history because their items are shared too.
+    std::shared_ptr<QFile> m_journal;
 };
 
 QDebug operator<<(QDebug debug, const History &history);
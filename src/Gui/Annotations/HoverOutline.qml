@@ -19,27 +19,15 @@ Loader {
     y: -root.document?.canvasRect.y ?? 0
     width: viewport.hoveredMousePath.boundingRect.width
     height: viewport.hoveredMousePath.boundingRect.height
-    sourceComponent: DashedOutline {
-        id: outline
+    sourceComponent: PathOutline {
         // Not animated because of scaling/flickering issues when the path becomes empty
         visible: !root.hidden && !viewport.hoveredMousePath.empty
             && viewport.hoveredMousePath.boundingRect !== root.document.selectedItem.mousePath.boundingRect
-        // These shapes can be complex and don't need to synchronize with any other visuals,
-        // so they don't need to be synchronous.
-        asynchronous: true
-        svgPath: root.viewport.hoveredMousePath.svgPath
+        path: root.viewport.hoveredMousePath
+        outerStroke: true
         strokeWidth: QmlUtils.clampPx(dprRound(1) / root.viewport.scale)
         strokeColor: palette.text
-        pathScale: {
-            const pathBounds = root.viewport.hoveredMousePath.boundingRect
-            return Qt.size(outerStrokeScaleValue(pathBounds.width, strokeWidth),
-                           outerStrokeScaleValue(pathBounds.height, strokeWidth))
-        }
-        transform: Translate {
-            x: outline.outerStrokeTranslateValue(root.viewport.hoveredMousePath.boundingRect.x,
-                                                 outline.pathScale.width, outline.strokeWidth)
-            y: outline.outerStrokeTranslateValue(root.viewport.hoveredMousePath.boundingRect.y,
-                                                 outline.pathScale.height, outline.strokeWidth)
-        }
+        dashColor: palette.base
+        dashLength: Kirigami.Units.mediumSpacing
     }
 }
@@ -0,0 +1,334 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "PathOutline.h"
+
+#include <QLineF>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+
+#include <algorithm>
+#include <cmath>
+
+using Vertex = QSGGeometry::ColoredPoint2D;
+
+// Limits how far the corners of sharp turns stick out, like QPen::miterLimit().
+static constexpr qreal miterLimit = 4;
+
+// QSGVertexColorMaterial expects premultiplied colors.
+static Vertex vertex(const QPointF &point, const QColor &color)
+{
+    const auto rgba = color.toRgb();
+    const auto alpha = rgba.alphaF();
+    Vertex v;
+    v.set(point.x(), point.y(), //
+          std::lround(rgba.redF() * alpha * 255),
+          std::lround(rgba.greenF() * alpha * 255),
+          std::lround(rgba.blueF() * alpha * 255),
+          std::lround(alpha * 255));
+    return v;
+}
+
+static QPointF unitNormal(const QPointF &start, const QPointF &end)
+{
+    const auto delta = end - start;
+    const auto length = std::hypot(delta.x(), delta.y());
+    return length > 0 ? QPointF{-delta.y() / length, delta.x() / length} : QPointF{};
+}
+
+/**
+ * The offset of every point of the polyline for a stroke half width of 1.
+ * At joins, this is the miter, so the quads of adjacent segments share an edge instead of
+ * overlapping. Overlapping quads would blend translucent strokes twice.
+ */
+static QList<QPointF> offsets(const QPolygonF &points, bool closed)
+{
+    const auto count = points.size();
+    QList<QPointF> result(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const bool hasPrevious = closed || i > 0;
+        const bool hasNext = closed || i < count - 1;
+        const auto previous = hasPrevious ? unitNormal(points[(i - 1 + count) % count], points[i]) : QPointF{};
+        const auto next = hasNext ? unitNormal(points[i], points[(i + 1) % count]) : QPointF{};
+        if (!hasPrevious || !hasNext) {
+            result[i] = hasPrevious ? previous : next;
+            continue;
+        }
+        auto miter = previous + next;
+        const auto length = std::hypot(miter.x(), miter.y());
+        if (length < 1e-6) {
+            // The path turns back on itself.
+            result[i] = next;
+            continue;
+        }
+        miter /= length;
+        const auto cosine = QPointF::dotProduct(miter, next);
+        result[i] = miter / std::max(cosine, 1 / miterLimit);
+    }
+    return result;
+}
+
+/**
+ * Append a stroke from start to end, where startOffset and endOffset come from offsets().
+ * The stroke has a solid core and a fringe that fades out over `feather` on each side,
+ * which antialiases the edges without needing multisampling.
+ */
+static void appendStroke(QList<Vertex> &vertices,
+                         const QPointF &start,
+                         const QPointF &end,
+                         const QPointF &startOffset,
+                         const QPointF &endOffset,
+                         qreal width,
+                         qreal feather,
+                         const QColor &color)
+{
+    auto coreColor = color;
+    if (width < feather) {
+        // Too thin for a solid core. Spread the same amount of color over the fringe.
+        coreColor.setAlphaF(color.alphaF() * width / feather);
+    }
+    const QColor transparent = Qt::transparent;
+    const qreal core = std::max<qreal>(0, (width - feather) / 2);
+    const qreal outer = std::max(width, feather) / 2 + feather / 2;
+    auto appendBand = [&](qreal from, qreal to, const QColor &fromColor, const QColor &toColor) {
+        const auto a = vertex(start + startOffset * from, fromColor);
+        const auto b = vertex(start + startOffset * to, toColor);
+        const auto c = vertex(end + endOffset * from, fromColor);
+        const auto d = vertex(end + endOffset * to, toColor);
+        vertices << a << b << c << c << b << d;
+    };
+    appendBand(-outer, -core, transparent, coreColor);
+    if (core > 0) {
+        appendBand(-core, core, coreColor, coreColor);
+    }
+    appendBand(core, outer, coreColor, transparent);
+}
+
+PathOutline::PathOutline(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+}
+
+QPainterPath PathOutline::path() const
+{
+    return m_path;
+}
+
+void PathOutline::setPath(const QPainterPath &path)
+{
+    if (path == m_path) {
+        return;
+    }
+    m_path = path;
+    Q_EMIT pathChanged();
+    markDirty();
+}
+
+qreal PathOutline::strokeWidth() const
+{
+    return m_strokeWidth;
+}
+
+void PathOutline::setStrokeWidth(qreal width)
+{
+    if (qFuzzyCompare(width, m_strokeWidth)) {
+        return;
+    }
+    m_strokeWidth = width;
+    Q_EMIT strokeWidthChanged();
+    markDirty();
+}
+
+QColor PathOutline::strokeColor() const
+{
+    return m_strokeColor;
+}
+
+void PathOutline::setStrokeColor(const QColor &color)
+{
+    if (color == m_strokeColor) {
+        return;
+    }
+    m_strokeColor = color;
+    Q_EMIT strokeColorChanged();
+    markDirty();
+}
+
+QColor PathOutline::dashColor() const
+{
+    return m_dashColor;
+}
+
+void PathOutline::setDashColor(const QColor &color)
+{
+    if (color == m_dashColor) {
+        return;
+    }
+    m_dashColor = color;
+    Q_EMIT dashColorChanged();
+    markDirty();
+}
+
+qreal PathOutline::dashLength() const
+{
+    return m_dashLength;
+}
+
+void PathOutline::setDashLength(qreal length)
+{
+    if (length == m_dashLength) {
+        return;
+    }
+    m_dashLength = length;
+    Q_EMIT dashLengthChanged();
+    markDirty();
+}
+
+bool PathOutline::outerStroke() const
+{
+    return m_outerStroke;
+}
+
+void PathOutline::setOuterStroke(bool outer)
+{
+    if (outer == m_outerStroke) {
+        return;
+    }
+    m_outerStroke = outer;
+    Q_EMIT outerStrokeChanged();
+    markDirty();
+}
+
+bool PathOutline::contains(const QPointF &point) const
+{
+    return m_path.contains(point);
+}
+
+void PathOutline::markDirty()
+{
+    m_geometryDirty = true;
+    update();
+}
+
+QSGNode *PathOutline::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    if (m_path.isEmpty() || m_strokeWidth <= 0) {
+        delete oldNode;
+        m_geometryDirty = true;
+        return nullptr;
+    }
+
+    auto node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_geometryDirty = true;
+    }
+    if (!m_geometryDirty) {
+        return node;
+    }
+    m_geometryDirty = false;
+
+    QTransform transform;
+    if (m_outerStroke) {
+        // Grow the bounds by half the stroke width on each side.
+        const auto bounds = m_path.boundingRect();
+        const auto center = bounds.center();
+        const qreal sx = bounds.width() > 0 ? (bounds.width() + m_strokeWidth) / bounds.width() : 1;
+        const qreal sy = bounds.height() > 0 ? (bounds.height() + m_strokeWidth) / bounds.height() : 1;
+        transform.translate(center.x(), center.y());
+        transform.scale(sx, sy);
+        transform.translate(-center.x(), -center.y());
+    }
+    // Curves are flattened here.
+    const auto polygons = m_path.toSubpathPolygons(transform);
+
+    // One device pixel in local coordinates. The stroke width is bound to the viewport scale,
+    // so the geometry is rebuilt whenever this changes.
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1;
+    const qreal scale = QLineF(mapToScene({0, 0}), mapToScene({1, 0})).length() * dpr;
+    const qreal feather = scale > 0 ? 1 / scale : 1;
+
+    QList<Vertex> vertices;
+    QList<Vertex> dashVertices;
+    const bool dashed = m_dashLength > 0;
+    const qreal dashPeriod = m_dashLength * 2;
+    qreal distance = 0; // Dashes continue across subpaths.
+    for (auto polygon : polygons) {
+        // Repeated points have no direction to offset them in.
+        polygon.erase(std::unique(polygon.begin(), polygon.end()), polygon.end());
+        const bool closed = polygon.size() > 2 && polygon.isClosed();
+        if (closed) {
+            polygon.removeLast();
+        } else if (polygon.size() > 1) {
+            // Square caps, like the miter joins used to fill in corners before.
+            const auto half = m_strokeWidth / 2;
+            // The direction of a segment is its normal turned back by 90 degrees.
+            const auto first = unitNormal(polygon[0], polygon[1]);
+            polygon.first() -= QPointF{first.y(), -first.x()} * half;
+            const auto last = unitNormal(polygon[polygon.size() - 2], polygon.last());
+            polygon.last() += QPointF{last.y(), -last.x()} * half;
+        }
+        if (polygon.size() < 2) {
+            continue;
+        }
+        const auto pointOffsets = offsets(polygon, closed);
+        const auto segmentCount = closed ? polygon.size() : polygon.size() - 1;
+        for (qsizetype i = 0; i < segmentCount; ++i) {
+            const auto next = (i + 1) % polygon.size();
+            const auto start = polygon[i];
+            const auto end = polygon[next];
+            appendStroke(vertices, start, end, pointOffsets[i], pointOffsets[next], m_strokeWidth, feather, m_strokeColor);
+            if (!dashed) {
+                continue;
+            }
+            const auto delta = end - start;
+            const auto length = std::hypot(delta.x(), delta.y());
+            if (length <= 0) {
+                continue;
+            }
+            const auto normal = unitNormal(start, end);
+            // Flat caps so that dashes and spaces have the same length.
+            qreal position = 0;
+            while (position < length) {
+                const auto phase = std::fmod(distance + position, dashPeriod);
+                if (phase < m_dashLength) {
+                    const auto dashEnd = std::min(length, position + m_dashLength - phase);
+                    // Dashes that go around a corner share the miter edge like the solid stroke.
+                    const auto startOffset = position == 0 ? pointOffsets[i] : normal;
+                    const auto endOffset = dashEnd == length ? pointOffsets[next] : normal;
+                    appendStroke(dashVertices,
+                                 start + delta * (position / length),
+                                 start + delta * (dashEnd / length),
+                                 startOffset,
+                                 endOffset,
+                                 m_strokeWidth,
+                                 feather,
+                                 m_dashColor);
+                    position = dashEnd;
+                } else {
+                    position += dashPeriod - phase;
+                }
+            }
+            distance += length;
+        }
+    }
+    // Dashes go last so that they are always drawn over the solid stroke.
+    vertices.append(dashVertices);
+
+    auto geometry = node->geometry();
+    geometry->allocate(vertices.size());
+    std::copy(vertices.cbegin(), vertices.cend(), geometry->vertexDataAsColoredPoint2D());
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
+
+#include "moc_PathOutline.cpp"
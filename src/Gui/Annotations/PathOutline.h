@@ -0,0 +1,87 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QPainterPath>
+#include <QQuickItem>
+#include <qqmlregistration.h>
+
+/**
+ * A solid or dashed outline of a QPainterPath, drawn as a single scene graph geometry node.
+ *
+ * This replaces Outline and DashedOutline for the mouse paths of annotations. Those need the path
+ * as an SVG path string, which is slow to build for long freehand strokes and gets parsed again by
+ * Qt Quick Shapes every time it changes. Here, curves are flattened and the stroke is triangulated
+ * directly from the path, only when the path or the stroke properties change. Segments meet at
+ * miter joins without overlapping, so translucent colors are blended once, and the edges fade out
+ * over one device pixel for antialiasing.
+ *
+ * The path uses the local coordinates of the item. Dashes are drawn on top of a solid stroke,
+ * like DashedOutline.
+ */
+class PathOutline : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(QPainterPath path READ path WRITE setPath NOTIFY pathChanged FINAL)
+    Q_PROPERTY(qreal strokeWidth READ strokeWidth WRITE setStrokeWidth NOTIFY strokeWidthChanged FINAL)
+    /// The stroke color beneath the dashes
+    Q_PROPERTY(QColor strokeColor READ strokeColor WRITE setStrokeColor NOTIFY strokeColorChanged FINAL)
+    Q_PROPERTY(QColor dashColor READ dashColor WRITE setDashColor NOTIFY dashColorChanged FINAL)
+    /// Length of the dashes and the spaces between them in logical pixels. 0 means no dashes.
+    Q_PROPERTY(qreal dashLength READ dashLength WRITE setDashLength NOTIFY dashLengthChanged FINAL)
+    /// Whether to grow the path around its center so that the stroke is outside of its bounding rect.
+    Q_PROPERTY(bool outerStroke READ outerStroke WRITE setOuterStroke NOTIFY outerStrokeChanged FINAL)
+
+public:
+    explicit PathOutline(QQuickItem *parent = nullptr);
+
+    QPainterPath path() const;
+    void setPath(const QPainterPath &path);
+
+    qreal strokeWidth() const;
+    void setStrokeWidth(qreal width);
+
+    QColor strokeColor() const;
+    void setStrokeColor(const QColor &color);
+
+    QColor dashColor() const;
+    void setDashColor(const QColor &color);
+
+    qreal dashLength() const;
+    void setDashLength(qreal length);
+
+    bool outerStroke() const;
+    void setOuterStroke(bool outer);
+
+    /**
+     * Whether the point is inside the filled path, like Shape.FillContains.
+     */
+    bool contains(const QPointF &point) const override;
+
+Q_SIGNALS:
+    void pathChanged();
+    void strokeWidthChanged();
+    void strokeColorChanged();
+    void dashColorChanged();
+    void dashLengthChanged();
+    void outerStrokeChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+
+private:
+    void markDirty();
+
+    QPainterPath m_path;
+    qreal m_strokeWidth = 1;
+    QColor m_strokeColor = Qt::black;
+    QColor m_dashColor = Qt::white;
+    qreal m_dashLength = 0;
+    bool m_outerStroke = false;
+    bool m_geometryDirty = true;
+};
@@ -80,28 +80,21 @@ AnimatedLoader {
             restoreMode: Binding.RestoreNone
         }
 
-        DashedOutline {
+        PathOutline {
             id: outline
-            svgPath: root.document.selectedItem.mousePath.svgPath
+            path: root.document.selectedItem.mousePath
             // Invisible when empty because of scaling/flickering issues when the path becomes empty
             visible: !root.document.selectedItem.mousePath.empty
+            outerStroke: true
             strokeWidth: QmlUtils.clampPx(dprRound(1) / root.viewport.scale)
+            strokeColor: palette.highlight
+            dashColor: palette.base
+            dashLength: Kirigami.Units.mediumSpacing
             width: root.width
             height: root.height
+            // The path is in document coordinates.
             x: -root.document.selectedItem.mousePath.boundingRect.x
             y: -root.document.selectedItem.mousePath.boundingRect.y
-            pathScale: {
-                const pathBounds = root.document.selectedItem.mousePath.boundingRect
-                return Qt.size(outerStrokeScaleValue(pathBounds.width, outline.strokeWidth),
-                               outerStrokeScaleValue(pathBounds.height, outline.strokeWidth))
-            }
-            transform: Translate {
-                x: outline.outerStrokeTranslateValue(root.document.selectedItem.mousePath.boundingRect.x,
-                                                     outline.pathScale.width, outline.strokeWidth)
-                y: outline.outerStrokeTranslateValue(root.document.selectedItem.mousePath.boundingRect.y,
-                                                     outline.pathScale.height, outline.strokeWidth)
-            }
-            containsMode: Outline.FillContains
             HoverHandler {
                 cursorShape: Qt.SizeAllCursor
             }
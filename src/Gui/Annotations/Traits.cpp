@@ -9,6 +9,9 @@
 #include "settings.h"
 #include <QLocale>
 #include <QUuid>
+#include <QVarLengthArray>
+
+#include <cstring>
 
 using namespace Qt::StringLiterals;
 using G = ::Geometry;
@@ -85,8 +88,8 @@ QImage Traits::ImageEffects::Blur::image(const std::function<QImage()> &getImage
         if (m_backingStoreCache.isNull()) {
             return m_backingStoreCache;
         }
-        // RGBA is better for use with OpenCV
-        m_backingStoreCache.convertTo(QImage::Format_RGBA8888_Premultiplied);
+        // A no-op unless the base image didn't come through SpectacleCore.
+        QtCV::convertTo(m_backingStoreCache);
         auto mat = QtCV::qImageToMat(m_backingStoreCache);
         // Below this, the effect is nearly invisible.
         static const qreal min = 0.5;
@@ -96,7 +99,7 @@ QImage Traits::ImageEffects::Blur::image(const std::function<QImage()> &getImage
         const qreal dynamicMin = 1 * dpr;
         const qreal dynamicMax = 16 * dpr;
         const qreal sigma = std::clamp(m_strength * (dynamicMax - dynamicMin) + dynamicMin, min, max);
-        QtCV::stackOrGaussianBlurCompatibility(mat, mat, {}, sigma, sigma);
+        QtCV::parallelStackOrGaussianBlur(mat, mat, sigma, sigma);
         m_backingStoreCache.setDevicePixelRatio(dpr);
         m_backingStoreCache.setText(strengthKey, strengthString(m_strength));
     }
@@ -107,6 +110,16 @@ QImage Traits::ImageEffects::Blur::image(const std::function<QImage()> &getImage
     return m_backingStoreCache;
 }
 
+qsizetype Traits::ImageEffects::Blur::cacheSize() const
+{
+    return m_backingStoreCache.sizeInBytes();
+}
+
+void Traits::ImageEffects::Blur::clearCache() const
+{
+    m_backingStoreCache = {};
+}
+
 Traits::ImageEffects::Pixelate::Pixelate(qreal strength)
     : m_strength(strength)
 {
@@ -124,38 +137,120 @@ void Traits::ImageEffects::Pixelate::setStrength(qreal strength)
         return;
     }
     m_strength = strength;
-    m_backingStoreCache = {};
+    // The original image doesn't depend on the strength.
+    m_resultCache = {};
+}
+
+// Average the colors of the `blockSize` sized blocks overlapping `rect` and fill the parts of the
+// blocks inside `rect` with them. Blocks are aligned to the top left of the source image, so items
+// next to each other or moved around always line up with the same blocks.
+// `source` must have 32 bit pixels with premultiplied or no alpha. The channel order doesn't matter.
+static QImage pixelate(const QImage &source, const QRect &rect, int blockSize)
+{
+    QImage result(rect.size(), source.format());
+    // Same as QImage::copy() for the parts outside of the source.
+    result.fill(0);
+    const auto area = rect & source.rect();
+    if (area.isEmpty()) {
+        return result;
+    }
+    // The block aligned area to average.
+    const int firstBlockX = area.left() / blockSize * blockSize;
+    const int firstBlockY = area.top() / blockSize * blockSize;
+    const int blockCount = (area.right() - firstBlockX) / blockSize + 1;
+    QVarLengthArray<quint32, 256> blockColors(blockCount);
+    QVarLengthArray<quint32, 256 * 4> sums(blockCount * 4);
+    for (int blockY = firstBlockY; blockY <= area.bottom(); blockY += blockSize) {
+        const int blockBottom = std::min(blockY + blockSize, source.height());
+        std::fill(sums.begin(), sums.end(), 0);
+        // Sum each channel of each block, one row at a time to read memory in order.
+        // These are simple loops over contiguous bytes that the compiler can vectorize.
+        for (int y = blockY; y < blockBottom; ++y) {
+            const uchar *line = source.constScanLine(y);
+            for (int block = 0; block < blockCount; ++block) {
+                const int left = firstBlockX + block * blockSize;
+                const int right = std::min(left + blockSize, source.width());
+                const uchar *pixel = line + left * 4;
+                const uchar *end = line + right * 4;
+                quint32 *sum = sums.data() + block * 4;
+                for (; pixel != end; pixel += 4) {
+                    sum[0] += pixel[0];
+                    sum[1] += pixel[1];
+                    sum[2] += pixel[2];
+                    sum[3] += pixel[3];
+                }
+            }
+        }
+        for (int block = 0; block < blockCount; ++block) {
+            const int left = firstBlockX + block * blockSize;
+            const int width = std::min(left + blockSize, source.width()) - left;
+            const quint32 count = width * (blockBottom - blockY);
+            const quint32 *sum = sums.data() + block * 4;
+            uchar color[4];
+            for (int channel = 0; channel < 4; ++channel) {
+                // Rounded to the nearest value.
+                color[channel] = (sum[channel] + count / 2) / count;
+            }
+            std::memcpy(&blockColors[block], color, 4);
+        }
+        // Write the block colors straight into the rows of the result inside the block.
+        const int top = std::max(blockY, area.top());
+        const int bottom = std::min(blockBottom, area.bottom() + 1);
+        for (int y = top; y < bottom; ++y) {
+            auto line = reinterpret_cast<quint32 *>(result.scanLine(y - rect.top()));
+            for (int block = 0; block < blockCount; ++block) {
+                const int left = std::max(firstBlockX + block * blockSize, area.left());
+                const int right = std::min(firstBlockX + (block + 1) * blockSize, area.right() + 1);
+                std::fill(line + left - rect.left(), line + right - rect.left(), blockColors[block]);
+            }
+        }
+    }
+    return result;
 }
 
 QImage Traits::ImageEffects::Pixelate::image(const std::function<QImage()> &getImage, QRectF rect, qreal dpr) const
 {
-    if ((m_backingStoreCache.isNull() //
-         || m_backingStoreCache.devicePixelRatio() != dpr //
-         || m_backingStoreCache.text(strengthKey).toDouble() != m_strength)
-        && getImage) {
+    if ((m_backingStoreCache.isNull() || m_backingStoreCache.devicePixelRatio() != dpr) && getImage) {
         m_backingStoreCache = getImage();
+        m_resultCache = {};
         if (m_backingStoreCache.isNull()) {
             return m_backingStoreCache;
         }
+        // The kernel needs 32 bit premultiplied pixels. A no-op for the working format.
+        QtCV::convertTo(m_backingStoreCache);
+        m_backingStoreCache.setDevicePixelRatio(dpr);
+    }
+    if (m_backingStoreCache.isNull()) {
+        return m_backingStoreCache;
+    }
+    QRect copyRect = G::rectScaled(rect, m_backingStoreCache.devicePixelRatio()).toAlignedRect();
+    if (m_resultCache.isNull() //
+        || m_resultRect != copyRect //
+        || m_resultCache.text(strengthKey).toDouble() != m_strength) {
         // 1x would have no effect and a fractional scale would look bad, so 2x is the minimum.
         static const qreal min = 2;
         // Scales with DPR to keep the effect looking similar for different image DPRs.
         const qreal dynamicMin = min * dpr;
         const qreal dynamicMax = 16 * dpr;
         const auto factor = std::max(std::round(m_strength * (dynamicMax - dynamicMin) + dynamicMin), min);
-        auto scaleDown = QTransform::fromScale(1 / factor, 1 / factor);
-        auto scaleUp = QTransform::fromScale(factor, factor);
-        // Smooth when scaling down to average out the colors.
-        m_backingStoreCache = m_backingStoreCache.transformed(scaleDown, Qt::SmoothTransformation);
-        m_backingStoreCache = m_backingStoreCache.transformed(scaleUp, Qt::FastTransformation);
-        m_backingStoreCache.setDevicePixelRatio(dpr);
-        m_backingStoreCache.setText(strengthKey, strengthString(m_strength));
-    }
-    QRect copyRect = G::rectScaled(rect, m_backingStoreCache.devicePixelRatio()).toAlignedRect();
-    if (copyRect.size() != m_backingStoreCache.size()) {
-        return m_backingStoreCache.copy(copyRect);
+        m_resultCache = pixelate(m_backingStoreCache, copyRect, int(factor));
+        m_resultCache.setDevicePixelRatio(dpr);
+        m_resultCache.setText(strengthKey, strengthString(m_strength));
+        m_resultRect = copyRect;
     }
-    return m_backingStoreCache;
+    return m_resultCache;
+}
+
+qsizetype Traits::ImageEffects::Pixelate::cacheSize() const
+{
+    return m_backingStoreCache.sizeInBytes() + m_resultCache.sizeInBytes();
+}
+
+void Traits::ImageEffects::Pixelate::clearCache() const
+{
+    m_backingStoreCache = {};
+    m_resultCache = {};
+    m_resultRect = {};
 }
 
 // Functions
@@ -599,6 +694,55 @@ QRectF Traits::visualRect(const OptTuple &traits)
     return visual ? visual->rect : QRectF{};
 }
 
+static qsizetype pathCost(const QPainterPath &path)
+{
+    return path.elementCount() * sizeof(QPainterPath::Element);
+}
+
+qsizetype Traits::memoryCost(const OptTuple &traits)
+{
+    qsizetype cost = sizeof(OptTuple);
+    if (auto &geometry = std::get<Geometry::Opt>(traits)) {
+        cost += pathCost(geometry->path);
+    }
+    if (auto &interactive = std::get<Interactive::Opt>(traits)) {
+        cost += pathCost(interactive->path);
+    }
+    if (auto &stroke = std::get<Stroke::Opt>(traits)) {
+        cost += pathCost(stroke->path);
+    }
+    if (auto &text = std::get<Text::Opt>(traits); text && text->index() == Text::String) {
+        cost += std::get<Text::String>(*text).size() * sizeof(QChar);
+    }
+    if (auto &fill = std::get<Fill::Opt>(traits)) {
+        if (fill->index() == Fill::Blur) {
+            cost += std::get<Fill::Blur>(*fill).cacheSize();
+        } else if (fill->index() == Fill::Pixelate) {
+            cost += std::get<Fill::Pixelate>(*fill).cacheSize();
+        }
+    }
+    return cost;
+}
+
+qsizetype Traits::clearEffectCache(const OptTuple &traits)
+{
+    auto &fill = std::get<Fill::Opt>(traits);
+    if (!fill) {
+        return 0;
+    }
+    qsizetype size = 0;
+    if (fill->index() == Fill::Blur) {
+        auto &blur = std::get<Fill::Blur>(*fill);
+        size = blur.cacheSize();
+        blur.clearCache();
+    } else if (fill->index() == Fill::Pixelate) {
+        auto &pixelate = std::get<Fill::Pixelate>(*fill);
+        size = pixelate.cacheSize();
+        pixelate.clearCache();
+    }
+    return size;
+}
+
 // QDebug operator<< declarations
 
 // Traits
@@ -99,6 +99,11 @@ public:
     // `dpr` should be the devicePixelRatio of the original image.
     QImage image(const std::function<QImage()> &getImage, QRectF rect, qreal dpr) const;
 
+    // The memory used by the cached image in bytes.
+    qsizetype cacheSize() const;
+    // Release the cached image. It will be regenerated the next time image() is called.
+    void clearCache() const;
+
     bool operator==(const Blur &other) const = default;
 
 private:
@@ -123,10 +128,20 @@ public:
     // `dpr` should be the devicePixelRatio of the original image.
     QImage image(const std::function<QImage()> &getImage, QRectF rect, qreal dpr) const;
 
+    // The memory used by the cached image in bytes.
+    qsizetype cacheSize() const;
+    // Release the cached image. It will be regenerated the next time image() is called.
+    void clearCache() const;
+
     bool operator==(const Pixelate &other) const = default;
 
 private:
+    // The original image. Only the blocks under the requested rect are pixelated,
+    // so this is kept to pixelate other rects when the item is moved or resized.
     mutable QImage m_backingStoreCache{};
+    // The pixelated image for m_resultRect.
+    mutable QImage m_resultCache{};
+    mutable QRect m_resultRect{};
     qreal m_strength = 0;
 };
 }
@@ -282,6 +297,13 @@ QPainterPath interactivePath(const OptTuple &traits);
 // Returns the Visual::rect or an empty rect if not available.
 QRectF visualRect(const OptTuple &traits);
 
+// Estimate of the memory used by the traits in bytes, including image effect caches.
+qsizetype memoryCost(const OptTuple &traits);
+
+// Release the image effect cache of the Fill trait, if any.
+// Returns the number of bytes released.
+qsizetype clearEffectCache(const OptTuple &traits);
+
 #undef COMMON_TRAIT_DEFS
 
 }
@@ -0,0 +1,66 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as QQC
+import org.kde.kirigami as Kirigami
+import org.kde.spectacle.private
+
+/**
+ * A horizontal strip of the frames taken in burst mode.
+ * Clicking a frame replaces the image being viewed with that frame.
+ */
+QQC.ToolBar {
+    id: root
+    readonly property BurstCapture burstCapture: SpectacleCore.burstCapture
+    readonly property real thumbnailHeight: Kirigami.Units.gridUnit * 4
+
+    position: QQC.ToolBar.Footer
+    contentHeight: thumbnailHeight + Kirigami.Units.mediumSpacing * 2
+
+    contentItem: RowLayout {
+        spacing: Kirigami.Units.mediumSpacing
+        ListView {
+            id: listView
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            orientation: ListView.Horizontal
+            spacing: Kirigami.Units.mediumSpacing
+            clip: true
+            model: root.burstCapture
+            currentIndex: root.burstCapture.currentIndex
+            highlightMoveDuration: 0
+            delegate: QQC.ItemDelegate {
+                id: delegate
+                required property int index
+                required property var frameId
+                required property size frameSize
+                height: ListView.view.height
+                width: Math.max(height, height * frameSize.width / Math.max(frameSize.height, 1))
+                padding: Kirigami.Units.smallSpacing
+                highlighted: ListView.isCurrentItem
+                contentItem: Image {
+                    // Frame IDs are never reused, so caching only keeps old frames alive.
+                    cache: false
+                    asynchronous: true
+                    fillMode: Image.PreserveAspectFit
+                    source: "image://burst/" + delegate.frameId
+                    sourceSize.height: Math.ceil(height * Screen.devicePixelRatio)
+                }
+                QQC.ToolTip.text: i18nc("@info:tooltip frame number in burst", "Frame %1 of %2", index + 1, listView.count)
+                QQC.ToolTip.visible: hovered
+                QQC.ToolTip.delay: Kirigami.Units.toolTipDelay
+                onClicked: root.burstCapture.select(index)
+            }
+        }
+        QQC.ToolButton {
+            Layout.alignment: Qt.AlignVCenter
+            icon.name: "document-save-all"
+            text: i18nc("@action:button save every frame of a burst", "Save All")
+            display: QQC.AbstractButton.TextBesideIcon
+            onClicked: root.burstCapture.exportAll()
+        }
+    }
+}
@@ -38,7 +38,11 @@ ColumnLayout {
                 SpectacleCore.cancelScreenshot()
             } else {
                 Settings.captureMode = model.captureMode
-                SpectacleCore.takeNewScreenshot()
+                if (Settings.burstCount > 1 && model.burstCapable) {
+                    SpectacleCore.takeBurst()
+                } else {
+                    SpectacleCore.takeNewScreenshot()
+                }
             }
         }
     }
@@ -79,4 +79,47 @@ ColumnLayout {
             enabled: !captureOnClickCheckBox.checked
         }
     }
+    RowLayout {
+        spacing: parent.spacing
+        QQC.Label {
+            text: i18nc("@label:spinbox number of screenshots taken in a row", "Burst:")
+        }
+        QQC.SpinBox {
+            id: burstCountSpinBox
+            from: 1
+            to: 64
+            value: Settings.burstCount
+            textFromValue: (value, locale) => {
+                return value > 1 ? i18ncp("@item:valuesuffix", "%1 shot", "%1 shots", value) : i18nc("@item burst mode disabled", "Off")
+            }
+            valueFromText: (text, locale) => {
+                const value = Number.fromLocaleString(locale, text.replace(/\D/g,''))
+                return isNaN(value) ? 1 : value
+            }
+            QQC.ToolTip.text: i18n("Take several screenshots in a row when a capture mode that doesn't need a selection is used.")
+            QQC.ToolTip.delay: Kirigami.Units.toolTipDelay
+            QQC.ToolTip.visible: hovered
+            onValueModified: Settings.burstCount = value
+        }
+    }
+    RowLayout {
+        spacing: parent.spacing
+        visible: burstCountSpinBox.value > 1
+        QQC.Label {
+            text: i18nc("@label:spinbox time between screenshots in burst mode", "Interval:")
+        }
+        QQC.SpinBox {
+            from: 0
+            to: 10000
+            stepSize: 100
+            value: Settings.burstInterval
+            textFromValue: (value, locale) => {
+                return i18ncp("@item:valuesuffix", "%1 millisecond", "%1 milliseconds", value)
+            }
+            valueFromText: (text, locale) => {
+                return Number.fromLocaleString(locale, text.replace(/\D/g,''))
+            }
+            onValueModified: Settings.burstInterval = value
+        }
+    }
 }
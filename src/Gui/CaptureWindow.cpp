@@ -8,6 +8,7 @@
 #include "CaptureWindow.h"
 
 #include "Config.h"
+#include "ScreenLayout.h"
 #include "SpectacleCore.h"
 #include "Gui/SelectionEditor.h"
 
@@ -18,7 +19,7 @@ using namespace Qt::StringLiterals;
 
 QList<CaptureWindow *> CaptureWindow::s_captureWindowInstances = {};
 
-CaptureWindow::CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWindow *parent)
+CaptureWindow::CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWindow *parent, bool incubate)
     : SpectacleWindow(engine, parent)
     , m_screenToFollow(screen)
 {
@@ -50,6 +51,16 @@ CaptureWindow::CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWi
             this, &CaptureWindow::syncGeometryWithScreen);
     syncGeometryWithScreen();
     Q_EMIT screenToFollowChanged();
+    auto updateLogicalScreenRect = [this] {
+        const auto rect = ScreenLayout::instance()->logicalRect(m_screenToFollow);
+        if (rect == m_logicalScreenRect) {
+            return;
+        }
+        m_logicalScreenRect = rect;
+        Q_EMIT logicalScreenRectChanged();
+    };
+    connect(ScreenLayout::instance(), &ScreenLayout::layoutChanged, this, updateLogicalScreenRect);
+    updateLogicalScreenRect();
 
     // sync visibility
     connect(this, &QWindow::visibilityChanged, this, [this](QWindow::Visibility visibility){
@@ -73,10 +84,13 @@ CaptureWindow::CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWi
     });
 
     // set up QML
-    setMode(mode); // sets source and other stuff based on mode.
-    if (auto rootItem = rootObject()) {
-        rootItem->installEventFilter(selectionEditor);
-    }
+    // The root object may only exist after incubation, so wait for it.
+    connect(this, &QQuickView::statusChanged, this, [this](QQuickView::Status status) {
+        if (auto rootItem = rootObject(); rootItem && status == QQuickView::Ready) {
+            rootItem->installEventFilter(SelectionEditor::instance());
+        }
+    });
+    setMode(mode, incubate); // sets source and other stuff based on mode.
 }
 
 CaptureWindow::~CaptureWindow()
@@ -95,6 +109,14 @@ CaptureWindow::UniquePointer CaptureWindow::makeUnique(Mode mode, QScreen *scree
     });
 }
 
+CaptureWindow::UniquePointer CaptureWindow::makeIncubating(Mode mode, QScreen *screen, QQmlEngine *engine)
+{
+    return UniquePointer(new CaptureWindow(mode, screen, engine, nullptr, true), [](CaptureWindow *window){
+        s_captureWindowInstances.removeOne(window);
+        deleter(window);
+    });
+}
+
 QList<CaptureWindow *> CaptureWindow::instances()
 {
     return s_captureWindowInstances;
@@ -105,7 +127,12 @@ QScreen *CaptureWindow::screenToFollow() const
     return m_screenToFollow;
 }
 
-void CaptureWindow::setMode(CaptureWindow::Mode mode)
+QRectF CaptureWindow::logicalScreenRect() const
+{
+    return m_logicalScreenRect;
+}
+
+void CaptureWindow::setMode(CaptureWindow::Mode mode, bool incubate)
 {
     if (mode == Image) {
         syncGeometryWithScreen();
@@ -114,8 +141,12 @@ void CaptureWindow::setMode(CaptureWindow::Mode mode)
             // the parent and window be null in Component.onCompleted
             {u"parent"_s, QVariant::fromValue(contentItem())}
         };
-        setSource(QUrl("%1/Gui/ImageCaptureOverlay.qml"_L1.arg(SPECTACLE_QML_PATH)),
-                  initialProperties);
+        const QUrl source("%1/Gui/ImageCaptureOverlay.qml"_L1.arg(SPECTACLE_QML_PATH));
+        if (incubate) {
+            incubateSource(source, initialProperties);
+        } else {
+            setSource(source, initialProperties);
+        }
     } else if (mode == Video) {
         syncGeometryWithScreen();
         QVariantMap initialProperties = {
@@ -123,8 +154,12 @@ void CaptureWindow::setMode(CaptureWindow::Mode mode)
             // the parent and window be null in Component.onCompleted
             {u"parent"_s, QVariant::fromValue(contentItem())}
         };
-        setSource(QUrl("%1/Gui/VideoCaptureOverlay.qml"_L1.arg(SPECTACLE_QML_PATH)),
-                  initialProperties);
+        const QUrl source("%1/Gui/VideoCaptureOverlay.qml"_L1.arg(SPECTACLE_QML_PATH));
+        if (incubate) {
+            incubateSource(source, initialProperties);
+        } else {
+            setSource(source, initialProperties);
+        }
     }
 }
 
@@ -17,6 +17,8 @@ class CaptureWindow : public SpectacleWindow
 {
     Q_OBJECT
     Q_PROPERTY(QScreen *screenToFollow READ screenToFollow NOTIFY screenToFollowChanged FINAL)
+    /// The logical rect of screenToFollow, cached by ScreenLayout.
+    Q_PROPERTY(QRectF logicalScreenRect READ logicalScreenRect NOTIFY logicalScreenRectChanged FINAL)
 
 public:
     enum Mode {
@@ -28,10 +30,19 @@ public:
 
     static UniquePointer makeUnique(Mode mode, QScreen *screen, QQmlEngine *engine, QWindow *parent = nullptr);
 
+    /**
+     * Same as makeUnique(), but the QML is incubated asynchronously.
+     * Used to get the UI ready while the screenshot is still being taken.
+     * Call finishIncubation() before showing the window.
+     */
+    static UniquePointer makeIncubating(Mode mode, QScreen *screen, QQmlEngine *engine);
+
     static QList<CaptureWindow *> instances();
 
     QScreen *screenToFollow() const;
 
+    QRectF logicalScreenRect() const;
+
 public Q_SLOTS:
     bool accept();
     void save() override;
@@ -41,18 +52,20 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     void screenToFollowChanged();
+    void logicalScreenRectChanged();
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
     void showEvent(QShowEvent *event) override;
 
 private:
-    explicit CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWindow *parent = nullptr);
+    explicit CaptureWindow(Mode mode, QScreen *screen, QQmlEngine *engine, QWindow *parent = nullptr, bool incubate = false);
     ~CaptureWindow();
 
-    void setMode(CaptureWindow::Mode mode);
+    void setMode(CaptureWindow::Mode mode, bool incubate);
     void syncGeometryWithScreen();
 
     QPointer<QScreen> m_screenToFollow;
+    QRectF m_logicalScreenRect;
     static QList<CaptureWindow *> s_captureWindowInstances;
 };
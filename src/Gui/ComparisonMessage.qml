@@ -0,0 +1,27 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+import QtQuick
+import QtQuick.Controls as QQC
+import org.kde.kirigami as Kirigami
+
+InlineMessage {
+    id: root
+    // messageArgument is the number of changed regions.
+    property real changedPercent: 0
+    type: messageArgument > 0 ? Kirigami.MessageType.Warning : Kirigami.MessageType.Positive
+    text: messageArgument > 0 ?
+        i18ncp("@info", "%1 changed region found (%2% of pixels changed).",
+               "%1 changed regions found (%2% of pixels changed).",
+               messageArgument, changedPercent.toLocaleString(Qt.locale(), 'f', 2))
+        : i18nc("@info", "No differences found.")
+    // Not using showCloseButton because it toggles visible on this item,
+    // making it harder to use with loaders.
+    actions: Kirigami.Action {
+        displayComponent: QQC.ToolButton {
+            icon.name: "dialog-close"
+            onClicked: root.loader.state = "inactive"
+        }
+    }
+}
@@ -19,8 +19,11 @@
 #include <KNotificationJobUiDelegate>
 #include <KStandardActions>
 #include <KStandardShortcut>
+#include <KSycoca>
 #include <kio_version.h>
 
+#include <QFileDialog>
+#include <QImageReader>
 #include <QJsonArray>
 #include <QMimeDatabase>
 #include <QPrintDialog>
@@ -44,21 +47,47 @@ ExportMenu::ExportMenu(QWidget *parent)
     : SpectacleMenu(parent)
 #ifdef PURPOSE_FOUND
     , mUpdatedImageAvailable(true)
-    , mPurposeMenu(new Purpose::Menu)
 #endif
 {
     addAction(QIcon::fromTheme(u"document-open-folder"_s),
               i18n("Open Default Screenshots Folder"),
               this, &ExportMenu::openScreenshotsFolder);
     addAction(KStandardActions::print(this, &ExportMenu::openPrintDialog, this));
+    addAction(QIcon::fromTheme(u"document-compare"_s),
+              i18nc("@action:inmenu", "Compare With Image…"),
+              this, &ExportMenu::openCompareDialog);
 
 #ifdef PURPOSE_FOUND
-    loadPurposeMenu();
     connect(ExportManager::instance(), &ExportManager::imageChanged, this, &ExportMenu::onImageChanged);
 #endif
 
-    addSeparator();
-    getKServiceItems();
+    // The Share menu and application actions are inserted before these separators
+    // when the menu is first shown.
+    mShareSeparator = addSeparator();
+    mServicesSeparator = addSeparator();
+
+    // now let the user manually chose an application to open the
+    // image with
+    QAction *openWith = new QAction(i18n("Other Application..."), this);
+    openWith->setShortcuts(KStandardShortcut::open());
+    connect(openWith, &QAction::triggered, this, [this]() {
+        const auto filename = imageUrlForLaunch();
+        if (filename.isEmpty()) {
+            return;
+        }
+        auto job = new KIO::ApplicationLauncherJob;
+        job->setUiDelegate(KIO::createDefaultJobUiDelegate(KJobUiDelegate::AutoHandlingEnabled, window()));
+        job->setUrls({filename});
+        job->start();
+    });
+    addAction(openWith);
+
+    // Querying the installed applications and share plugins is slow when there are many of them,
+    // so it is only done when the menu is actually used.
+    connect(this, &QMenu::aboutToShow, this, &ExportMenu::populate);
+    connect(KSycoca::self(), &KSycoca::databaseChanged, this, [this] {
+        mServicesStale = true;
+    });
 }
 
 ExportMenu *ExportMenu::instance()
@@ -71,12 +100,48 @@ void ExportMenu::onImageChanged()
 #ifdef PURPOSE_FOUND
     // mark cached image as stale
     mUpdatedImageAvailable = true;
-    mPurposeMenu->clear();
+    if (mPurposeMenu) {
+        mPurposeMenu->clear();
+    }
 #endif
 }
 
-void ExportMenu::getKServiceItems()
+QUrl ExportMenu::imageUrlForLaunch()
 {
+    auto captureWindow = qobject_cast<CaptureWindow *>(getWidgetTransientParent(this));
+    if (captureWindow && !captureWindow->accept()) {
+        return {};
+    }
+    if (ExportManager::instance()->isImageSavedNotInTemp()) {
+        return Settings::self()->lastImageSaveLocation();
+    }
+    const auto filename = ExportManager::instance()->getAutosaveFilename();
+    SpectacleCore::instance()->syncExportImage();
+    ExportManager::instance()->exportImage(ExportManager::Save, filename);
+    return filename;
+}
+
+void ExportMenu::populate()
+{
+#ifdef PURPOSE_FOUND
+    if (!mPurposeMenu) {
+        loadPurposeMenu();
+    }
+#endif
+    updateServiceActions();
+}
+
+void ExportMenu::updateServiceActions()
+{
+    // Emits databaseChanged if the applications changed since the last query.
+    KSycoca::self()->ensureCacheValid();
+    if (!mServicesStale) {
+        return;
+    }
+    mServicesStale = false;
+    qDeleteAll(mServiceActions);
+    mServiceActions.clear();
+
     // populate all locally installed applications and services
     // which can handle images first
 
@@ -87,18 +152,10 @@ void ExportMenu::getKServiceItems()
         QAction *action = new QAction(QIcon::fromTheme(service->icon()), name, this);
 
         connect(action, &QAction::triggered, this, [this, service]() {
-            auto captureWindow = qobject_cast<CaptureWindow *>(getWidgetTransientParent(this));
-            if(captureWindow && !captureWindow->accept()) {
+            const auto filename = imageUrlForLaunch();
+            if (filename.isEmpty()) {
                 return;
             }
-            QUrl filename;
-            if(ExportManager::instance()->isImageSavedNotInTemp()) {
-                filename = Settings::self()->lastImageSaveLocation();
-            } else {
-                filename = ExportManager::instance()->getAutosaveFilename();
-                SpectacleCore::instance()->syncExportImage();
-                ExportManager::instance()->exportImage(ExportManager::Save, filename);
-            }
 
             auto *job = new KIO::ApplicationLauncherJob(service);
             auto *delegate = new KNotificationJobUiDelegate;
@@ -108,45 +165,19 @@ void ExportMenu::getKServiceItems()
             job->setUrls({filename});
             job->start();
         });
-        addAction(action);
+        mServiceActions.append(action);
     }
-
-    // now let the user manually chose an application to open the
-    // image with
-
-    addSeparator();
-
-    QAction *openWith = new QAction(i18n("Other Application..."), this);
-    openWith->setShortcuts(KStandardShortcut::open());
-
-    connect(openWith, &QAction::triggered, this, [this]() {
-        auto captureWindow = qobject_cast<CaptureWindow *>(getWidgetTransientParent(this));
-        if(captureWindow && !captureWindow->accept()) {
-            return;
-        }
-        QUrl filename;
-        if(ExportManager::instance()->isImageSavedNotInTemp()) {
-            filename = Settings::self()->lastImageSaveLocation();
-        } else {
-            filename = ExportManager::instance()->getAutosaveFilename();
-            SpectacleCore::instance()->syncExportImage();
-            ExportManager::instance()->exportImage(ExportManager::Save, filename);
-        }
-
-        auto job = new KIO::ApplicationLauncherJob;
-        job->setUiDelegate(KIO::createDefaultJobUiDelegate(KJobUiDelegate::AutoHandlingEnabled, window()));
-        job->setUrls({filename});
-        job->start();
-    });
-    addAction(openWith);
+    insertActions(mServicesSeparator, mServiceActions);
 }
 
 #ifdef PURPOSE_FOUND
 void ExportMenu::loadPurposeMenu()
 {
     // attach the menu
+    // The share plugins are only loaded when the Share menu is shown.
+    mPurposeMenu = std::make_unique<Purpose::Menu>();
     auto purposeMenu = mPurposeMenu.get();
-    QAction *purposeMenuAction = addMenu(purposeMenu);
+    QAction *purposeMenuAction = insertMenu(mShareSeparator, purposeMenu);
     purposeMenuAction->setObjectName("purposeMenuAction");
     purposeMenuAction->setText(i18n("Share"));
     purposeMenuAction->setIcon(QIcon::fromTheme(u"document-share"_s));
@@ -231,4 +262,34 @@ void ExportMenu::openPrintDialog()
     dialog->setVisible(true);
 }
 
+void ExportMenu::openCompareDialog()
+{
+    if (auto captureWindow = qobject_cast<CaptureWindow *>(getWidgetTransientParent(this))) {
+        captureWindow->accept();
+    }
+    QStringList mimeTypeFilters;
+    const auto mimeTypes = QImageReader::supportedMimeTypes();
+    for (const auto &mimeType : mimeTypes) {
+        mimeTypeFilters.append(QString::fromUtf8(mimeType));
+    }
+
+    auto dialog = new QFileDialog;
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setAcceptMode(QFileDialog::AcceptOpen);
+    dialog->setFileMode(QFileDialog::ExistingFile);
+    dialog->setWindowTitle(i18nc("@title:window", "Compare With Image"));
+    dialog->setDirectoryUrl(Settings::imageSaveLocation());
+    dialog->setMimeTypeFilters(mimeTypeFilters);
+    dialog->selectMimeTypeFilter(u"image/png"_s);
+
+    // properly set the transientparent chain
+    setWidgetTransientParent(dialog, getWidgetTransientParent(this));
+
+    connect(dialog, &QFileDialog::urlSelected, dialog, [](const QUrl &url) {
+        SpectacleCore::instance()->compareWith(url);
+    });
+
+    dialog->setVisible(true);
+}
+
 #include "moc_ExportMenu.cpp"
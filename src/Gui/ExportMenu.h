@@ -40,6 +40,7 @@ public:
 
 public Q_SLOTS:
     void openPrintDialog();
+    void openCompareDialog();
 
 Q_SIGNALS:
     void imageShared(int error, const QString &message);
@@ -50,7 +51,17 @@ private:
     Q_SLOT void onImageChanged();
     Q_SLOT void openScreenshotsFolder();
 
-    void getKServiceItems();
+    void populate();
+    void updateServiceActions();
+    // Save the image if needed and return the URL to open in another application.
+    // Returns an empty URL if the capture was canceled.
+    QUrl imageUrlForLaunch();
+
+    QAction *mShareSeparator = nullptr;
+    QAction *mServicesSeparator = nullptr;
+    QList<QAction *> mServiceActions;
+    // Set when the installed applications may have changed since the last query.
+    bool mServicesStale = true;
 
 #ifdef PURPOSE_FOUND
     void loadPurposeMenu();
@@ -39,7 +39,7 @@ MouseArea {
         anchors.fill: parent
         visible: true
         enabled: contextWindow.annotating
-        viewportRect: Geometry.mapFromPlatformRect(screenToFollow.geometry, screenToFollow.devicePixelRatio)
+        viewportRect: contextWindow.logicalScreenRect
     }
 
     component Overlay: Rectangle {
@@ -121,52 +121,19 @@ MouseArea {
         x: -annotations.viewportRect.x
         y: -annotations.viewportRect.y
         enabled: selectionRectangle.enabled
-        component SelectionHandle: Handle {
-            visible: enabled && selectionRectangle.visible
-                && SelectionEditor.dragLocation === SelectionEditor.None
-                && Geometry.rectIntersects(Qt.rect(x,y,width,height), annotations.viewportRect)
-            fillColor: selectionRectangle.border.color
-        }
-
-        SelectionHandle {
-            edges: Qt.TopEdge | Qt.LeftEdge
-            x: SelectionEditor.handlesRect.x
-            y: SelectionEditor.handlesRect.y
-        }
-        SelectionHandle {
-            edges: Qt.LeftEdge
-            x: SelectionEditor.handlesRect.x
-            y: SelectionEditor.handlesRect.y + SelectionEditor.handlesRect.height/2 - height/2
-        }
-        SelectionHandle {
-            edges: Qt.LeftEdge | Qt.BottomEdge
-            x: SelectionEditor.handlesRect.x
-            y: SelectionEditor.handlesRect.y + SelectionEditor.handlesRect.height - height
-        }
-        SelectionHandle {
-            edges: Qt.TopEdge
-            x: SelectionEditor.handlesRect.x + SelectionEditor.handlesRect.width/2 - width/2
-            y: SelectionEditor.handlesRect.y
-        }
-        SelectionHandle {
-            edges: Qt.BottomEdge
-            x: SelectionEditor.handlesRect.x + SelectionEditor.handlesRect.width/2 - width/2
-            y: SelectionEditor.handlesRect.y + SelectionEditor.handlesRect.height - height
-        }
-        SelectionHandle {
-            edges: Qt.RightEdge
-            x: SelectionEditor.handlesRect.x + SelectionEditor.handlesRect.width - width
-            y: SelectionEditor.handlesRect.y + SelectionEditor.handlesRect.height/2 - height/2
-        }
-        SelectionHandle {
-            edges: Qt.TopEdge | Qt.RightEdge
-            x: SelectionEditor.handlesRect.x + SelectionEditor.handlesRect.width - width
-            y: SelectionEditor.handlesRect.y
-        }
-        SelectionHandle {
-            edges: Qt.RightEdge | Qt.BottomEdge
-            x: SelectionEditor.handlesRect.x + SelectionEditor.handlesRect.width - width
-            y: SelectionEditor.handlesRect.y + SelectionEditor.handlesRect.height - height
+        Repeater {
+            model: SelectionEditor.handles
+            delegate: Handle {
+                required edges
+                required property point position
+                visible: enabled && selectionRectangle.visible
+                    && SelectionEditor.dragLocation === SelectionEditor.None
+                    && Geometry.rectIntersects(Qt.rect(x,y,width,height), annotations.viewportRect)
+                fillColor: selectionRectangle.border.color
+                // Centered on the midpoints that SelectionEditor uses to find the handle under the mouse.
+                x: position.x - width / 2
+                y: position.y - height / 2
+            }
         }
     }
 
@@ -113,7 +113,7 @@ EmptyPage {
             left: footerLoader.left
             right: captureOptionsLoader.left
             top: inlineMessageLoader.bottom
-            bottom: footerLoader.top
+            bottom: burstFilmstripLoader.top
         }
         sourceComponent: SpectacleCore.videoMode ? recordingViewComponent : screenshotViewComponent
         Component {
@@ -126,6 +126,19 @@ EmptyPage {
         }
     }
 
+    Loader { // parent is contentItem
+        id: burstFilmstripLoader
+        anchors {
+            left: footerLoader.left
+            right: captureOptionsLoader.left
+            bottom: footerLoader.top
+        }
+        visible: !SpectacleCore.videoMode && SpectacleCore.burstCapture.count > 1
+        active: visible
+        height: visible ? implicitHeight : 0
+        sourceComponent: BurstFilmstrip {}
+    }
+
     Loader { // parent is contentItem
         id: captureOptionsLoader
         visible: true
@@ -95,6 +95,8 @@ ButtonGrid {
         icon.name: "edit-image"
         text: i18nc("@action:button edit screenshot", "Edit…")
         visible: !SpectacleCore.videoMode
+        // The base image may only be a preview while loading.
+        enabled: !SpectacleCore.imageLoading
         checkable: true
         checked: contextWindow.annotating
         onToggled: contextWindow.annotating = checked
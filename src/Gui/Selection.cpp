@@ -169,64 +169,71 @@ void Selection::setRect(qreal x, qreal y, qreal w, qreal h)
 
 void Selection::setRect(const QRectF &newRect, Qt::Orientations orientations)
 {
-    const QRectF oldRect = selection;
     const auto &bounds = editor->screensRect();
     selection = G::rectClipped(newRect, bounds, orientations);
+    if (flushPending || selection == notifiedSelection) {
+        return;
+    }
+    flushPending = true;
+    // Queued so that all changes made while handling the same event are emitted together.
+    QMetaObject::invokeMethod(this, &Selection::flushChanges, Qt::QueuedConnection);
+}
+
+void Selection::flushChanges()
+{
+    flushPending = false;
+    const QRectF oldRect = notifiedSelection;
+    notifiedSelection = selection;
     // Using this instead of just comparing rects to take advantage
     // of the qFuzzyCompare calculations we're doing anyway.
     bool rectChange = false;
     bool sizeChange = false;
-    // Keeping track of which things change without unnecessarily
-    // sending signals or sending signals more than once is tough.
-    if (orientations & Qt::Horizontal) {
-        if (!qFuzzyCompare(oldRect.x(), selection.x())) {
-            rectChange = true;
-            Q_EMIT xChanged();
-        }
-        qreal oldHC = oldRect.x() + oldRect.width() / 2.0;
-        qreal newHC = selection.x() + selection.width() / 2.0;
-        if (!qFuzzyCompare(oldHC, newHC)) {
-            rectChange = true;
-            Q_EMIT horizontalCenterChanged();
-        }
-        if (!qFuzzyCompare(oldRect.width(), selection.width())) {
-            rectChange = true;
-            sizeChange = true;
-            Q_EMIT widthChanged();
-        }
-        if (!qFuzzyCompare(oldRect.left(), selection.left())) {
-            rectChange = true;
-            Q_EMIT leftChanged();
-        }
-        if (!qFuzzyCompare(oldRect.right(), selection.right())) {
-            rectChange = true;
-            Q_EMIT rightChanged();
-        }
+    // Compare both orientations since several changes may have been made since the last time.
+    if (!qFuzzyCompare(oldRect.x(), selection.x())) {
+        rectChange = true;
+        Q_EMIT xChanged();
+    }
+    qreal oldHC = oldRect.x() + oldRect.width() / 2.0;
+    qreal newHC = selection.x() + selection.width() / 2.0;
+    if (!qFuzzyCompare(oldHC, newHC)) {
+        rectChange = true;
+        Q_EMIT horizontalCenterChanged();
+    }
+    if (!qFuzzyCompare(oldRect.width(), selection.width())) {
+        rectChange = true;
+        sizeChange = true;
+        Q_EMIT widthChanged();
+    }
+    if (!qFuzzyCompare(oldRect.left(), selection.left())) {
+        rectChange = true;
+        Q_EMIT leftChanged();
+    }
+    if (!qFuzzyCompare(oldRect.right(), selection.right())) {
+        rectChange = true;
+        Q_EMIT rightChanged();
+    }
+    if (!qFuzzyCompare(oldRect.y(), selection.y())) {
+        rectChange = true;
+        Q_EMIT yChanged();
+    }
+    qreal oldVC = oldRect.y() + oldRect.height() / 2.0;
+    qreal newVC = selection.y() + selection.height() / 2.0;
+    if (!qFuzzyCompare(oldVC, newVC)) {
+        rectChange = true;
+        Q_EMIT verticalCenterChanged();
+    }
+    if (!qFuzzyCompare(oldRect.height(), selection.height())) {
+        rectChange = true;
+        sizeChange = true;
+        Q_EMIT heightChanged();
+    }
+    if (!qFuzzyCompare(oldRect.top(), selection.top())) {
+        rectChange = true;
+        Q_EMIT topChanged();
     }
-    if (orientations & Qt::Vertical) {
-        if (!qFuzzyCompare(oldRect.y(), selection.y())) {
-            rectChange = true;
-            Q_EMIT yChanged();
-        }
-        qreal oldVC = oldRect.y() + oldRect.height() / 2.0;
-        qreal newVC = selection.y() + selection.height() / 2.0;
-        if (!qFuzzyCompare(oldVC, newVC)) {
-            rectChange = true;
-            Q_EMIT verticalCenterChanged();
-        }
-        if (!qFuzzyCompare(oldRect.height(), selection.height())) {
-            rectChange = true;
-            sizeChange = true;
-            Q_EMIT heightChanged();
-        }
-        if (!qFuzzyCompare(oldRect.top(), selection.top())) {
-            rectChange = true;
-            Q_EMIT topChanged();
-        }
-        if (!qFuzzyCompare(oldRect.bottom(), selection.bottom())) {
-            rectChange = true;
-            Q_EMIT bottomChanged();
-        }
+    if (!qFuzzyCompare(oldRect.bottom(), selection.bottom())) {
+        rectChange = true;
+        Q_EMIT bottomChanged();
     }
     if (rectChange) {
         Q_EMIT rectChanged();
@@ -14,6 +14,10 @@ class SelectionEditor;
 /**
  * This class provides information about the selected rectangle capture region and a few related utilities.
  * Uses logical global coordinates.
+ *
+ * The rect is updated immediately, but change signals are coalesced and emitted from the event loop.
+ * Dragging changes the rect several times per pointer event and every property has a lot of
+ * bindings in each capture window, so this way they are only re-evaluated once per frame.
  */
 class Selection : public QObject
 {
@@ -79,7 +83,14 @@ public:
     void moveTo(const QPointF &p);
 
     void setRect(const QRectF &r);
-    void setRect(qreal x, qreal y, qreal w, qreal h);
+    // Use this instead of setting x, y, width and height one after the other.
+    Q_INVOKABLE void setRect(qreal x, qreal y, qreal w, qreal h);
+
+    /**
+     * Emit the signals of changes that haven't been notified yet right now.
+     * Only needed when something must see the new values before control returns to the event loop.
+     */
+    void flushChanges();
 
     QRectF rectF() const;
     QSizeF sizeF() const;
@@ -113,6 +124,9 @@ private:
     void setRect(const QRectF &newRect, Qt::Orientations orientations);
 
     QRectF selection;
+    // The rect as of the last time change signals were emitted.
+    QRectF notifiedSelection;
+    bool flushPending = false;
     // mainly exists so that I don't have to qobject_cast the parent
     SelectionEditor *const editor;
 };
@@ -120,6 +120,7 @@ public:
     }
 
     const std::unique_ptr<Selection> selection;
+    const std::unique_ptr<SelectionHandleModel> handles;
 
     QPointF startPos;
     QPointF initialTopLeft;
@@ -143,6 +144,7 @@ public:
 SelectionEditorPrivate::SelectionEditorPrivate(SelectionEditor *q)
     : q(q)
     , selection(new Selection(q))
+    , handles(new SelectionHandleModel(q))
 {
 }
 
@@ -201,6 +203,8 @@ void SelectionEditorPrivate::updateHandlePositions()
     // left-center handle
     handlePositions[7] = QPointF{left - offset - offsetLeft, centerY};
 
+    handles->setPositions(handlePositions);
+
     QPointF radiusOffset = {handleRadius, handleRadius};
     QRectF newHandlesRect = {handlePositions[0] - radiusOffset, // top left
                              handlePositions[2] + radiusOffset}; // bottom right
@@ -411,6 +415,11 @@ QRectF SelectionEditor::handlesRect() const
     return d->handlesRect;
 }
 
+SelectionHandleModel *SelectionEditor::handles() const
+{
+    return d->handles.get();
+}
+
 QPointF SelectionEditor::mousePosition() const
 {
     return d->mousePos;
@@ -432,6 +441,9 @@ bool SelectionEditor::acceptSelection(ExportManager::Actions actions)
         return false;
     }
 
+    // Changes made while handling the same event would otherwise be notified after accepted(),
+    // restarting work (e.g., a speculative export) for a selection that is already done.
+    d->selection->flushChanges();
     auto selectionRect = d->selection->normalized();
     if (Settings::rememberSelectionRect() == Settings::Always) {
         Settings::setSelectionRect(selectionRect.toAlignedRect());
@@ -14,6 +14,7 @@
 #include <QQmlEngine>
 
 #include "Selection.h"
+#include "SelectionHandleModel.h"
 
 class QHoverEvent;
 class QKeyEvent;
@@ -37,6 +38,8 @@ class SelectionEditor : public QObject
     Q_PROPERTY(QRectF screensRect READ screensRect NOTIFY screensRectChanged FINAL)
     Q_PROPERTY(Location dragLocation READ dragLocation NOTIFY dragLocationChanged FINAL)
     Q_PROPERTY(QRectF handlesRect READ handlesRect NOTIFY handlesRectChanged FINAL)
+    /// The resize handles as a model, so only handles that moved are updated in QML.
+    Q_PROPERTY(SelectionHandleModel *handles READ handles CONSTANT FINAL)
     Q_PROPERTY(QPointF mousePosition READ mousePosition NOTIFY mousePositionChanged)
     /// Whether or not to show the magnifier.
     Q_PROPERTY(bool showMagnifier READ showMagnifier NOTIFY showMagnifierChanged FINAL)
@@ -73,6 +76,8 @@ public:
 
     QRectF handlesRect() const;
 
+    SelectionHandleModel *handles() const;
+
     QPointF mousePosition() const;
 
     bool showMagnifier() const;
@@ -0,0 +1,85 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "SelectionHandleModel.h"
+
+using namespace Qt::StringLiterals;
+
+SelectionHandleModel::SelectionHandleModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+Qt::Edges SelectionHandleModel::edges(int handle)
+{
+    switch (handle) {
+    case 0:
+        return Qt::TopEdge | Qt::LeftEdge;
+    case 1:
+        return Qt::TopEdge | Qt::RightEdge;
+    case 2:
+        return Qt::BottomEdge | Qt::RightEdge;
+    case 3:
+        return Qt::BottomEdge | Qt::LeftEdge;
+    case 4:
+        return Qt::TopEdge;
+    case 5:
+        return Qt::RightEdge;
+    case 6:
+        return Qt::BottomEdge;
+    case 7:
+        return Qt::LeftEdge;
+    default:
+        return {};
+    }
+}
+
+QPointF SelectionHandleModel::position(int handle) const
+{
+    return m_positions.value(handle);
+}
+
+void SelectionHandleModel::setPositions(const QList<QPointF> &positions)
+{
+    Q_ASSERT(positions.size() == handleCount);
+    static const QList<int> roles{PositionRole};
+    for (int i = 0; i < handleCount; ++i) {
+        if (m_positions[i] == positions[i]) {
+            continue;
+        }
+        m_positions[i] = positions[i];
+        const auto index = this->index(i);
+        Q_EMIT dataChanged(index, index, roles);
+    }
+}
+
+QHash<int, QByteArray> SelectionHandleModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roleNames{
+        {EdgesRole, "edges"_ba},
+        {PositionRole, "position"_ba},
+    };
+    return roleNames;
+}
+
+QVariant SelectionHandleModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid)) {
+        return {};
+    }
+    const int row = index.row();
+    if (role == EdgesRole) {
+        return int(edges(row));
+    } else if (role == PositionRole) {
+        return m_positions.at(row);
+    }
+    return {};
+}
+
+int SelectionHandleModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : handleCount;
+}
+
+#include "moc_SelectionHandleModel.cpp"
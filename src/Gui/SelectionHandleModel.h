@@ -0,0 +1,47 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QPointF>
+#include <qqmlregistration.h>
+
+/**
+ * The resize handles of the selection for a Repeater in each capture window.
+ *
+ * Positions are the midpoints of the handles in logical global coordinates.
+ * Only the rows of handles that actually moved are reported as changed, so dragging one edge
+ * doesn't re-evaluate the bindings of handles on the other side of the selection.
+ */
+class SelectionHandleModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Created by SelectionEditor")
+
+public:
+    explicit SelectionHandleModel(QObject *parent = nullptr);
+
+    enum {
+        EdgesRole = Qt::UserRole + 1,
+        PositionRole = Qt::UserRole + 2,
+    };
+
+    static constexpr int handleCount = 8;
+
+    // Same order as the positions: top-left, top-right, bottom-right, bottom-left,
+    // top, right, bottom and left.
+    static Qt::Edges edges(int handle);
+
+    QPointF position(int handle) const;
+    void setPositions(const QList<QPointF> &positions);
+
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+private:
+    QList<QPointF> m_positions = QList<QPointF>{handleCount};
+};
@@ -8,6 +8,7 @@
 
 #include "SpectacleWindow.h"
 
+#include "DebugUtils.h"
 #include "ExportManager.h"
 #include "SpectacleCore.h"
 #include "Geometry.h"
@@ -26,6 +27,7 @@
 #include <QColorDialog>
 #include <QFontDialog>
 #include <QtQml>
+#include <functional>
 #include <utility>
 
 using namespace Qt::StringLiterals;
@@ -39,6 +41,27 @@ QString SpectacleWindow::s_previousTitle = QGuiApplication::applicationDisplayNa
 bool SpectacleWindow::s_synchronizingAnnotating = false;
 bool SpectacleWindow::s_isAnnotating = false;
 
+class SpectacleWindowIncubator : public QQmlIncubator
+{
+public:
+    SpectacleWindowIncubator(std::function<void()> &&onFinished)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_onFinished(std::move(onFinished))
+    {
+    }
+
+protected:
+    void statusChanged(Status status) override
+    {
+        if (status == Ready || status == Error) {
+            m_onFinished();
+        }
+    }
+
+private:
+    std::function<void()> m_onFinished;
+};
+
 SpectacleWindow::SpectacleWindow(QQmlEngine *engine, QWindow *parent)
     : QQuickView(engine, parent)
     , m_context(new QQmlContext(engine->rootContext(), this))
@@ -198,6 +221,7 @@ void SpectacleWindow::deleter(SpectacleWindow *window)
 
 void SpectacleWindow::setSource(const QUrl &source, const QVariantMap &initialProperties)
 {
+    m_incubator.reset();
     if (source.isEmpty()) {
         m_component.reset(nullptr);
         QQuickView::setSource(source);
@@ -234,6 +258,49 @@ void SpectacleWindow::setSource(const QUrl &source, const QVariantMap &initialPr
     setContent(source, component, object);
 }
 
+void SpectacleWindow::incubateSource(const QUrl &source, const QVariantMap &initialProperties)
+{
+    m_incubator.reset();
+    m_finishIncubation = false;
+    m_component.reset(new QQmlComponent(engine(), source, QQmlComponent::Asynchronous, this));
+    auto *component = m_component.get();
+
+    auto create = [this, component, source, initialProperties]() {
+        if (!component->isReady()) {
+            setContent(source, component, nullptr);
+            return;
+        }
+        m_incubator = std::make_unique<SpectacleWindowIncubator>([this, component, source]() {
+            if (m_incubator->isError()) {
+                Log::warning() << "Cannot create" << source << m_incubator->errors();
+            }
+            setContent(source, component, m_incubator->object());
+        });
+        m_incubator->setInitialProperties(initialProperties);
+        component->create(*m_incubator, m_context.get());
+        if (m_finishIncubation) {
+            m_incubator->forceCompletion();
+        }
+    };
+
+    if (component->isLoading()) {
+        connect(component, &QQmlComponent::statusChanged, this, [this, component, create]() {
+            disconnect(component, &QQmlComponent::statusChanged, this, nullptr);
+            create();
+        });
+    } else {
+        create();
+    }
+}
+
+void SpectacleWindow::finishIncubation()
+{
+    m_finishIncubation = true;
+    if (m_incubator && m_incubator->isLoading()) {
+        m_incubator->forceCompletion();
+    }
+}
+
 void SpectacleWindow::save()
 {
     SpectacleCore::instance()->syncExportImage();
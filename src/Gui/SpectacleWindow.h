@@ -8,6 +8,7 @@
 
 #include <QQuickView>
 #include <QQmlContext>
+#include <QQmlIncubator>
 
 class SpectacleWindowPrivate;
 
@@ -79,6 +80,12 @@ public:
      */
     Q_INVOKABLE QString baseFileName(const QUrl &url) const;
 
+    /**
+     * Create the rest of the QML that is still incubating right away.
+     * If the QML file is still being compiled, it is created all at once as soon as it is ready.
+     */
+    void finishIncubation();
+
 public Q_SLOTS:
     virtual void save();
     virtual void saveAs();
@@ -108,6 +115,10 @@ protected:
     // set source, but with a window specific QQmlContext and initial properties
     void setSource(const QUrl &source, const QVariantMap &initialProperties);
 
+    // Same as setSource(), but the QML is compiled on a worker thread and created with an asynchronous
+    // QQmlIncubator a little at a time between other events. The content is set when it is done.
+    void incubateSource(const QUrl &source, const QVariantMap &initialProperties);
+
     void mousePressEvent(QMouseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
@@ -122,6 +133,9 @@ protected:
 
     const std::unique_ptr<QQmlContext> m_context;
     std::unique_ptr<QQmlComponent> m_component;
+    // After m_component so that objects still being incubated are deleted first.
+    std::unique_ptr<QQmlIncubator> m_incubator;
+    bool m_finishIncubation = false;
 
     QKeySequence m_pressedKeys;
 };
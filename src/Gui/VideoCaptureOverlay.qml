@@ -12,8 +12,7 @@ import org.kde.spectacle.private
 
 MouseArea {
     id: root
-    readonly property rect viewportRect: Geometry.mapFromPlatformRect(screenToFollow.geometry,
-                                                               screenToFollow.devicePixelRatio)
+    readonly property rect viewportRect: contextWindow.logicalScreenRect
     focus: true
     acceptedButtons: Qt.LeftButton | Qt.RightButton
     hoverEnabled: true
@@ -199,6 +199,12 @@ void ViewerWindow::showQRCodeScannedMessage(const QVariant &messageArgument)
     showInlineMessage("%1/Gui/QRCodeScannedMessage.qml"_L1.arg(SPECTACLE_QML_PATH), {{"messageArgument"_L1, messageArgument}});
 }
 
+void ViewerWindow::showComparisonMessage(int changedRegions, qreal changedPercent)
+{
+    showInlineMessage("%1/Gui/ComparisonMessage.qml"_L1.arg(SPECTACLE_QML_PATH),
+                      {{"messageArgument"_L1, changedRegions}, {"changedPercent"_L1, changedPercent}});
+}
+
 void ViewerWindow::showImageSharedMessage(int errorCode, const QString &messageArgument)
 {
     if (errorCode == 1 || status() != QQuickView::Ready) {
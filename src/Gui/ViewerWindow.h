@@ -41,6 +41,7 @@ public:
     void showScreenshotFailedMessage(const QString &messageArgument);
     void showRecordingFailedMessage(const QString &messageArgument);
     void showQRCodeScannedMessage(const QVariant &messageArgument);
+    void showComparisonMessage(int changedRegions, qreal changedPercent);
 
     Q_INVOKABLE void startDrag();
 
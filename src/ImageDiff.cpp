@@ -0,0 +1,125 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "ImageDiff.h"
+#include "QtCV.h"
+
+#include <algorithm>
+
+// A read only cv::Mat for an image that is already in the right format.
+// Unlike QtCV::qImageToMat, this doesn't detach the image.
+static cv::Mat constMat(const QImage &image)
+{
+    return cv::Mat(cv::Size{image.width(), image.height()}, QtCV::matType(image.pixelFormat()), const_cast<uchar *>(image.constBits()), image.bytesPerLine());
+}
+
+// For every pixel in `pixels`, whether each channel is within the range of the same channel
+// in the 3x3 neighborhood of `neighbors`, give or take the tolerance.
+static cv::Mat foundInNeighborhood(const cv::Mat &pixels, const cv::Mat &neighbors, int tolerance)
+{
+    static const auto kernel = cv::getStructuringElement(cv::MORPH_RECT, {3, 3});
+    cv::Mat lower;
+    cv::Mat upper;
+    // Erosion and dilation are per channel min and max filters.
+    cv::erode(neighbors, lower, kernel);
+    cv::dilate(neighbors, upper, kernel);
+    if (tolerance > 0) {
+        // Saturating arithmetic, so no need to clamp.
+        cv::subtract(lower, cv::Scalar::all(tolerance), lower);
+        cv::add(upper, cv::Scalar::all(tolerance), upper);
+    }
+    cv::Mat result;
+    cv::inRange(pixels, lower, upper, result);
+    return result;
+}
+
+ImageDiff::Result ImageDiff::compare(const QImage &reference, const QImage &image, const Options &options)
+{
+    Result result;
+    if (image.isNull()) {
+        return result;
+    }
+    // Not premultiplied so that transparent pixels with different colors aren't considered equal.
+    constexpr auto format = QImage::Format_RGBA8888;
+    const auto after = QtCV::convertedTo(image, format);
+    const auto before = QtCV::convertedTo(reference, format);
+    const auto common = after.rect() & before.rect();
+    result.totalPixels = qsizetype(after.width()) * after.height();
+
+    // Largest difference of any channel for each pixel.
+    cv::Mat delta(after.height(), after.width(), CV_8U, cv::Scalar::all(255));
+    // Pixels that count as changed.
+    cv::Mat mask(after.height(), after.width(), CV_8U, cv::Scalar::all(255));
+
+    if (!common.isEmpty()) {
+        const cv::Rect roi{0, 0, common.width(), common.height()};
+        const auto afterMat = constMat(after)(roi);
+        const auto beforeMat = constMat(before)(roi);
+        cv::Mat channelDiff;
+        cv::absdiff(afterMat, beforeMat, channelDiff);
+        // absdiff always gives us a continuous matrix, so we can view it as one row per pixel
+        // and reduce each row to its largest value.
+        cv::Mat maxDiff;
+        cv::reduce(channelDiff.reshape(1, roi.area()), maxDiff, 1, cv::REDUCE_MAX);
+        auto deltaRoi = delta(roi);
+        maxDiff.reshape(1, roi.height).copyTo(deltaRoi);
+        auto maskRoi = mask(roi);
+        cv::compare(deltaRoi, options.tolerance, maskRoi, cv::CMP_GT);
+        if (options.ignoreAntialiasing && cv::countNonZero(maskRoi) > 0) {
+            cv::Mat antialiased;
+            cv::bitwise_and(foundInNeighborhood(afterMat, beforeMat, options.tolerance), //
+                            foundInNeighborhood(beforeMat, afterMat, options.tolerance),
+                            antialiased);
+            maskRoi.setTo(0, antialiased);
+        }
+    }
+
+    result.changedPixels = cv::countNonZero(mask);
+    if (result.changedPixels == 0) {
+        return result;
+    }
+
+    // Group nearby changes so that a changed line of text isn't dozens of separate regions.
+    cv::Mat grouped;
+    const int distance = std::max(0, options.mergeDistance);
+    if (distance > 0) {
+        cv::dilate(mask, grouped, cv::getStructuringElement(cv::MORPH_RECT, {distance * 2 + 1, distance * 2 + 1}));
+    } else {
+        grouped = mask;
+    }
+    cv::Mat labels;
+    cv::Mat stats;
+    cv::Mat centroids;
+    const int count = cv::connectedComponentsWithStats(grouped, labels, stats, centroids, 8, CV_32S);
+    // Label 0 is the unchanged background.
+    for (int i = 1; i < count; ++i) {
+        const cv::Rect groupRect{stats.at<int>(i, cv::CC_STAT_LEFT),
+                                 stats.at<int>(i, cv::CC_STAT_TOP),
+                                 stats.at<int>(i, cv::CC_STAT_WIDTH),
+                                 stats.at<int>(i, cv::CC_STAT_HEIGHT)};
+        // Shrink back to the changed pixels since dilation made the group bigger.
+        const auto rect = cv::boundingRect(mask(groupRect));
+        if (rect.empty()) {
+            continue;
+        }
+        result.changedRects.append({groupRect.x + rect.x, groupRect.y + rect.y, rect.width, rect.height});
+    }
+    std::ranges::sort(result.changedRects, [](const QRect &lhs, const QRect &rhs) {
+        return lhs.y() != rhs.y() ? lhs.y() < rhs.y() : lhs.x() < rhs.x();
+    });
+
+    // Make even the smallest visible differences stand out.
+    cv::Mat intensity;
+    delta.convertTo(intensity, CV_8U, 0.75, 64);
+    cv::Mat colored;
+    cv::applyColorMap(intensity, colored, cv::COLORMAP_HOT);
+    result.heatmap = QImage(after.size(), format);
+    result.heatmap.setDevicePixelRatio(image.devicePixelRatio());
+    auto heatmapMat = QtCV::qImageToMat(result.heatmap);
+    cv::cvtColor(colored, heatmapMat, cv::COLOR_BGR2RGBA);
+    cv::Mat alpha;
+    mask.convertTo(alpha, CV_8U, 160.0 / 255.0);
+    cv::insertChannel(alpha, heatmapMat, 3);
+    return result;
+}
@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+
+/**
+ * Pixel comparison of two images, meant for visual regression checks of screenshots.
+ *
+ * The per-pixel work is done with OpenCV, which uses vectorized kernels for the platform.
+ */
+namespace ImageDiff
+{
+struct Options {
+    // The largest difference of any color channel (0-255) that still counts as unchanged.
+    int tolerance = 0;
+    // Ignore changed pixels when the color of each image can be found in the 3x3 neighborhood of
+    // the other image. This is what anti-aliased edges moved by less than a pixel look like.
+    bool ignoreAntialiasing = true;
+    // Changed pixels that are at most this many pixels apart are put in the same region.
+    int mergeDistance = 8;
+};
+
+struct Result {
+    // Same size as the compared image. Only changed pixels are visible, more opaque and brighter
+    // for larger differences. Uses the device pixel ratio of the compared image.
+    QImage heatmap;
+    // Bounding rectangles of groups of changed pixels in raw pixel coordinates,
+    // sorted from top to bottom and left to right.
+    QList<QRect> changedRects;
+    qsizetype changedPixels = 0;
+    qsizetype totalPixels = 0;
+
+    bool hasChanges() const
+    {
+        return changedPixels > 0;
+    }
+};
+
+/**
+ * Compare `image` against `reference`. Both images are aligned at their top left corners.
+ * When the sizes are different, the parts of `image` outside of `reference` count as changed.
+ */
+Result compare(const QImage &reference, const QImage &image, const Options &options = {});
+}
@@ -0,0 +1,22 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "ImageHash.h"
+
+#include <QHashFunctions>
+
+size_t ImageHash::pixelHash(const QImage &image)
+{
+    size_t seed = qHash(image.size(), qHash(image.format()));
+    const qsizetype lineBytes = (qsizetype(image.width()) * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y) {
+        seed = qHashBits(image.constScanLine(y), lineBytes, seed);
+    }
+    return seed;
+}
+
+bool ImageHash::samePixels(const QImage &lhs, size_t lhsHash, const QImage &rhs, size_t rhsHash)
+{
+    return lhsHash == rhsHash && lhs == rhs;
+}
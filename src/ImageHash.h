@@ -0,0 +1,24 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QImage>
+
+/**
+ * Cheap checks for captured frames that are exact duplicates of each other.
+ */
+namespace ImageHash
+{
+/**
+ * A fast hash of the visible pixels of the image. Padding bytes at the end of scanlines are ignored.
+ */
+size_t pixelHash(const QImage &image);
+
+/**
+ * Whether two images have exactly the same pixels, given their pixelHash() values.
+ * The pixels are only compared when the hashes match, since comparing whole images is slow.
+ */
+bool samePixels(const QImage &lhs, size_t lhsHash, const QImage &rhs, size_t rhsHash);
+}
@@ -11,6 +11,7 @@
 #include "CommandLineOptions.h"
 #include "SpectacleDBusAdapter.h"
 #include "ScreenShotEffect.h"
+#include "QtCV.h"
 #include "settings.h"
 
 #include <QApplication>
@@ -36,6 +37,7 @@ int main(int argc, char **argv)
     QCoreApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
     QIcon::setFallbackThemeName(u"breeze"_s);
     QApplication app(argc, argv);
+    QtCV::initializeThreading();
 
     KLocalizedString::setApplicationDomain(QByteArrayLiteral("spectacle"));
     QCoreApplication::setOrganizationDomain(u"org.kde"_s);
@@ -117,6 +119,7 @@ int main(int argc, char **argv)
     SpectacleDBusAdapter *dbusAdapter = new SpectacleDBusAdapter(spectacleCore);
     QObject::connect(spectacleCore, &SpectacleCore::dbusScreenshotFailed, dbusAdapter, &SpectacleDBusAdapter::ScreenshotFailed);
     QObject::connect(spectacleCore, &SpectacleCore::dbusRecordingFailed, dbusAdapter, &SpectacleDBusAdapter::RecordingFailed);
+    QObject::connect(spectacleCore->periodicCapture(), &PeriodicCapture::frameSaved, dbusAdapter, &SpectacleDBusAdapter::PeriodicCaptureSaved);
     QObject::connect(ExportManager::instance(),
                      &ExportManager::imageExported,
                      spectacleCore,
@@ -0,0 +1,148 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "MultiResolutionImage.h"
+#include "Geometry.h"
+#include "ImageMetaData.h"
+#include "QtCV.h"
+
+#include <algorithm>
+#include <cmath>
+
+using G = Geometry;
+
+// A read only cv::Mat for an image that is already in the right format.
+// Unlike QtCV::qImageToMat, this doesn't detach the image.
+static cv::Mat constMat(const QImage &image)
+{
+    return cv::Mat(cv::Size{image.width(), image.height()}, QtCV::matType(image.pixelFormat()), const_cast<uchar *>(image.constBits()), image.bytesPerLine());
+}
+
+// Truncate to ints instead of rounding to prevent ROIs from going out of bounds.
+static QRect truncatedRect(const QRectF &rect)
+{
+    return QRect(rect.x(), rect.y(), rect.width(), rect.height());
+}
+
+MultiResolutionImage::MultiResolutionImage(const QList<QImage> &images)
+{
+    m_tiles.reserve(images.size());
+    qreal maxDpr = 0;
+    bool allSameDpr = true;
+    for (const auto &image : images) {
+        if (image.isNull()) {
+            continue;
+        }
+        const auto dpr = image.devicePixelRatio();
+        allSameDpr = allSameDpr && (m_tiles.empty() || dpr == maxDpr);
+        maxDpr = std::max(maxDpr, dpr);
+        const QRectF rect{ImageMetaData::logicalXY(image), image.deviceIndependentSize()};
+        m_rect |= rect;
+        m_tiles.append({QtCV::convertedTo(image), rect});
+    }
+    if (!m_tiles.empty()) {
+        m_devicePixelRatio = allSameDpr ? maxDpr : std::ceil(maxDpr);
+    }
+}
+
+bool MultiResolutionImage::isNull() const
+{
+    return m_tiles.empty();
+}
+
+const QList<MultiResolutionImage::Tile> &MultiResolutionImage::tiles() const
+{
+    return m_tiles;
+}
+
+QRectF MultiResolutionImage::rect() const
+{
+    return m_rect;
+}
+
+qreal MultiResolutionImage::devicePixelRatio() const
+{
+    return m_devicePixelRatio;
+}
+
+QImage MultiResolutionImage::image(const QRectF &rect, qreal dpr) const
+{
+    if (m_tiles.empty() || rect.isEmpty() || dpr <= 0) {
+        return {};
+    }
+    QImage result{(rect.size() * dpr).toSize(), QtCV::workingFormat};
+    if (result.isNull()) {
+        return {};
+    }
+    result.fill(Qt::transparent);
+    auto resultMat = QtCV::qImageToMat(result);
+    ImageMetaData::SubGeometryList geometryList;
+    bool resampled = false;
+    for (const auto &tile : m_tiles) {
+        const auto section = tile.rect.intersected(rect);
+        if (section.isEmpty()) {
+            continue;
+        }
+        const auto tileDpr = tile.image.devicePixelRatio();
+        geometryList << ImageMetaData::subGeometryPropertyMap(tile.rect, tileDpr);
+        resampled = resampled || tileDpr != dpr;
+        const auto sourceRect = truncatedRect(G::rectScaled(section.translated(-tile.rect.topLeft()), tileDpr)) & tile.image.rect();
+        const auto targetRect = truncatedRect(G::rectScaled(section.translated(-rect.topLeft()), dpr)) & result.rect();
+        if (sourceRect.isEmpty() || targetRect.isEmpty()) {
+            continue;
+        }
+        const auto sourceMat = constMat(tile.image)(cv::Rect{sourceRect.x(), sourceRect.y(), sourceRect.width(), sourceRect.height()});
+        auto targetMat = resultMat(cv::Rect{targetRect.x(), targetRect.y(), targetRect.width(), targetRect.height()});
+        if (sourceRect.size() == targetRect.size()) {
+            sourceMat.copyTo(targetMat);
+            continue;
+        }
+        // Integer DPR screens stay crisp when scaled up with area interpolation.
+        // It is also the best for scaling down.
+        const bool hasIntDpr = static_cast<int>(tileDpr) == tileDpr;
+        const bool scalingDown = targetRect.width() < sourceRect.width();
+        const auto interpolation = hasIntDpr || scalingDown ? cv::INTER_AREA : cv::INTER_LANCZOS4;
+        cv::resize(sourceMat, targetMat, targetMat.size(), 0, 0, interpolation);
+    }
+    result.setDevicePixelRatio(dpr);
+    // Needed for scaling exported sections back down to the DPR of the screens they came from.
+    if (geometryList.size() > 1 || resampled) {
+        ImageMetaData::setSubGeometryList(result, geometryList);
+    }
+    return result;
+}
+
+QImage MultiResolutionImage::toImage() const
+{
+    if (m_tiles.size() == 1 && m_tiles.constFirst().rect == m_rect) {
+        return m_tiles.constFirst().image;
+    }
+    return image(m_rect, m_devicePixelRatio);
+}
+
+MultiResolutionImage MultiResolutionImage::intersected(const QRectF &rect) const
+{
+    MultiResolutionImage result;
+    result.m_rect = m_rect;
+    result.m_devicePixelRatio = m_devicePixelRatio;
+    for (const auto &tile : m_tiles) {
+        const auto section = tile.rect.intersected(rect);
+        if (section.isEmpty()) {
+            continue;
+        }
+        if (section == tile.rect) {
+            result.m_tiles.append(tile);
+            continue;
+        }
+        const auto dpr = tile.image.devicePixelRatio();
+        const auto pixelRect = truncatedRect(G::rectScaled(section.translated(-tile.rect.topLeft()), dpr)) & tile.image.rect();
+        if (pixelRect.isEmpty()) {
+            continue;
+        }
+        // Use the rect of the pixels we actually kept so that they don't get stretched.
+        const QRectF logicalRect{tile.rect.topLeft() + QPointF(pixelRect.topLeft()) / dpr, QSizeF(pixelRect.size()) / dpr};
+        result.m_tiles.append({tile.image.copy(pixelRect), logicalRect});
+    }
+    return result;
+}
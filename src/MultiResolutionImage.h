@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QMetaType>
+#include <QRectF>
+
+/**
+ * A screenshot of several screens that keeps every screen at its own device pixel ratio.
+ *
+ * Combining a 1x screen with a 2x screen into one QImage means storing, annotating and encoding
+ * the 1x screen at 2x, which takes 4 times the memory for that screen, only for it to be scaled
+ * back down again on export. This keeps the images of each screen as they were captured and only
+ * resamples the parts of them that are actually needed, at the device pixel ratio they are needed
+ * at.
+ *
+ * Rects are logical rects in the same coordinate system as the logical positions of the screens.
+ * Like QImage, copies are cheap because the images of the screens are implicitly shared.
+ */
+class MultiResolutionImage
+{
+public:
+    struct Tile {
+        // The image of a screen at the screen's device pixel ratio.
+        QImage image;
+        // The logical rect of the screen.
+        QRectF rect;
+    };
+
+    MultiResolutionImage() = default;
+    // Screens are positioned with ImageMetaData::logicalXY().
+    // The images are converted to QtCV::workingFormat if they aren't already.
+    explicit MultiResolutionImage(const QList<QImage> &images);
+
+    bool isNull() const;
+
+    const QList<Tile> &tiles() const;
+
+    // The union of the rects of all screens.
+    QRectF rect() const;
+
+    // The device pixel ratio of toImage(): the highest one of all screens, rounded up to the next
+    // integer when the screens don't all have the same one so that integer DPR screens stay crisp.
+    qreal devicePixelRatio() const;
+
+    // A new image of the section of all screens intersecting `rect` at the given device pixel ratio.
+    // Only the parts of the screens within `rect` are resampled. Sections not covered by any screen
+    // are transparent. The sub geometry list of the image has every screen intersecting `rect`.
+    QImage image(const QRectF &rect, qreal dpr) const;
+
+    // All screens combined into one image at devicePixelRatio().
+    QImage toImage() const;
+
+    // A copy that only keeps the pixels of the screens within `rect`.
+    // The rect and device pixel ratio stay the same, so sections keep their coordinates.
+    // Everything outside of `rect` becomes transparent.
+    MultiResolutionImage intersected(const QRectF &rect) const;
+
+private:
+    QList<Tile> m_tiles;
+    QRectF m_rect;
+    qreal m_devicePixelRatio = 1;
+};
+
+Q_DECLARE_METATYPE(MultiResolutionImage)
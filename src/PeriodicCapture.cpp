@@ -0,0 +1,266 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "PeriodicCapture.h"
+#include "DebugUtils.h"
+#include "ExportManager.h"
+#include "ImageHash.h"
+#include "ImageMetaData.h"
+#include "settings.h"
+
+#include <KLocalizedString>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+// Anything shorter than this is faster than most platforms can grab anyway.
+static constexpr int minimumInterval = 50;
+
+struct EncodeResult {
+    QString filePath;
+    QString errorString;
+    qint64 cost = 0;
+    bool success = false;
+};
+
+static EncodeResult encodeFrame(const QImage &image, const QString &filePath, const QByteArray &suffix)
+{
+    EncodeResult result{filePath};
+    QElapsedTimer timer;
+    timer.start();
+    const QFileInfo fileInfo(filePath);
+    if (!QDir().mkpath(fileInfo.path())) {
+        result.errorString = xi18nc("@info", "Creating the directory failed:<nl/><filename>%1</filename>", fileInfo.path());
+        return result;
+    }
+    // QSaveFile only replaces the file when everything was written,
+    // so something watching the directory never sees half written frames.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.errorString = file.errorString();
+        return result;
+    }
+    if (!ExportManager::encodeImage(image, &file, suffix, &result.errorString)) {
+        file.cancelWriting();
+        if (result.errorString.isEmpty()) {
+            result.errorString = i18n("Error while writing file.");
+        }
+        return result;
+    }
+    result.success = file.commit();
+    if (!result.success) {
+        result.errorString = file.errorString();
+    }
+    result.cost = timer.elapsed();
+    return result;
+}
+
+PeriodicCapture::PeriodicCapture(QObject *parent)
+    : QObject(parent)
+{
+    // Encoding is usually much faster than the interval.
+    // More threads would only compete with the compositor for CPU time.
+    m_pool.setMaxThreadCount(2);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &PeriodicCapture::requestGrab);
+}
+
+PeriodicCapture::~PeriodicCapture()
+{
+    m_pool.waitForDone();
+}
+
+bool PeriodicCapture::start(int intervalMsec, bool skipUnchanged)
+{
+    if (!Settings::imageSaveLocation().isLocalFile()) {
+        Log::warning() << "Periodic capture requires a local image save location";
+        return false;
+    }
+    m_skipUnchanged = skipUnchanged;
+    m_lastHash = 0;
+    m_lastFrame = {};
+    m_received = 0;
+    m_saved = 0;
+    m_skipped = 0;
+    m_dropped = 0;
+    m_failed = 0;
+    m_lastCaptureCost = 0;
+    m_lastEncodeCost = 0;
+    m_totalCaptureCost = 0;
+    m_totalEncodeCost = 0;
+    m_lastFileName.clear();
+
+    const bool wasActive = isActive();
+    m_timer.start(std::max(intervalMsec, minimumInterval));
+    if (!wasActive) {
+        Q_EMIT activeChanged();
+    }
+    Q_EMIT statusChanged();
+    requestGrab();
+    return true;
+}
+
+void PeriodicCapture::stop()
+{
+    if (!isActive()) {
+        return;
+    }
+    m_timer.stop();
+    m_lastFrame = {};
+    Q_EMIT activeChanged();
+    Q_EMIT statusChanged();
+    checkFinished();
+}
+
+bool PeriodicCapture::isActive() const
+{
+    return m_timer.isActive();
+}
+
+int PeriodicCapture::interval() const
+{
+    return m_timer.interval();
+}
+
+int PeriodicCapture::backlog() const
+{
+    return m_backlog;
+}
+
+bool PeriodicCapture::isIdle() const
+{
+    return !isActive() && !m_waitingForGrab && m_backlog == 0;
+}
+
+bool PeriodicCapture::isWaitingForGrab() const
+{
+    return m_waitingForGrab;
+}
+
+void PeriodicCapture::requestGrab()
+{
+    if (m_waitingForGrab) {
+        // The platform is still busy with the previous grab.
+        // Don't pile up requests, just wait for the next tick.
+        Log::debug() << "Periodic capture: previous grab still pending after" << m_grabTimer.elapsed() << "ms";
+        return;
+    }
+    m_waitingForGrab = true;
+    m_grabTimer.start();
+    Q_EMIT grabRequested();
+}
+
+void PeriodicCapture::addFrame(const QImage &image)
+{
+    m_waitingForGrab = false;
+    if (image.isNull()) {
+        checkFinished();
+        return;
+    }
+    ++m_received;
+    m_lastCaptureCost = m_grabTimer.elapsed();
+    m_totalCaptureCost += m_lastCaptureCost;
+
+    if (m_skipUnchanged) {
+        const auto hash = ImageHash::pixelHash(image);
+        if (ImageHash::samePixels(m_lastFrame, m_lastHash, image, hash)) {
+            ++m_skipped;
+            Q_EMIT statusChanged();
+            checkFinished();
+            return;
+        }
+        m_lastHash = hash;
+        m_lastFrame = image;
+    }
+
+    if (m_backlog >= maximumBacklog) {
+        ++m_dropped;
+        Log::warning() << "Periodic capture: dropping frame, encoding backlog is full";
+        Q_EMIT statusChanged();
+        checkFinished();
+        return;
+    }
+
+    const auto filePath = nextFilePath(image, QDateTime::currentDateTime());
+    const auto suffix = Settings::preferredImageFormat().toLower().toLatin1();
+    m_pendingPaths.insert(filePath);
+    ++m_backlog;
+    Q_EMIT statusChanged();
+
+    QtConcurrent::run(&m_pool, encodeFrame, image, filePath + u'.' + QString::fromLatin1(suffix), suffix)
+        .then(this, [this, filePath](const EncodeResult &result) {
+            m_pendingPaths.remove(filePath);
+            --m_backlog;
+            if (result.success) {
+                ++m_saved;
+                m_lastEncodeCost = result.cost;
+                m_totalEncodeCost += result.cost;
+                m_lastFileName = result.filePath;
+                Q_EMIT frameSaved(result.filePath, m_lastCaptureCost, m_lastEncodeCost, m_backlog);
+            } else {
+                ++m_failed;
+                Log::warning() << "Periodic capture: cannot save" << result.filePath << result.errorString;
+                Q_EMIT frameFailed(result.errorString);
+            }
+            Q_EMIT statusChanged();
+            checkFinished();
+        });
+}
+
+QVariantMap PeriodicCapture::status() const
+{
+    const int encoded = m_saved + m_failed;
+    return {
+        {u"active"_s, isActive()},
+        {u"interval"_s, interval()},
+        {u"backlog"_s, m_backlog},
+        {u"maximumBacklog"_s, maximumBacklog},
+        {u"received"_s, m_received},
+        {u"saved"_s, m_saved},
+        {u"skipped"_s, m_skipped},
+        {u"dropped"_s, m_dropped},
+        {u"failed"_s, m_failed},
+        {u"lastCaptureCost"_s, m_lastCaptureCost},
+        {u"lastEncodeCost"_s, m_lastEncodeCost},
+        {u"averageCaptureCost"_s, m_received > 0 ? m_totalCaptureCost / m_received : 0},
+        {u"averageEncodeCost"_s, encoded > 0 ? m_totalEncodeCost / encoded : 0},
+        {u"lastFileName"_s, m_lastFileName},
+    };
+}
+
+QString PeriodicCapture::nextFilePath(const QImage &image, const QDateTime &timestamp)
+{
+    const QDir baseDir(ExportManager::defaultSaveLocation());
+    const auto filename = ExportManager::formattedFilename(Settings::periodicFilenameTemplate(),
+                                                           timestamp,
+                                                           ImageMetaData::windowTitle(image),
+                                                           Settings::imageSaveLocation());
+    const auto extension = u'.' + Settings::preferredImageFormat().toLower();
+    const auto basePath = baseDir.filePath(filename);
+    // Frames that are still being encoded don't exist on disk yet, so check those too.
+    // Unlike ExportManager, we only support local files here, so a stat job isn't needed.
+    auto isUsed = [this, &extension](const QString &path) {
+        return m_pendingPaths.contains(path) || QFileInfo::exists(path + extension);
+    };
+    QString result = basePath;
+    for (int i = 1; isUsed(result); ++i) {
+        result = basePath + u'-' + QString::number(i);
+    }
+    return result;
+}
+
+void PeriodicCapture::checkFinished()
+{
+    if (isIdle()) {
+        Q_EMIT finished();
+    }
+}
+
+#include "moc_PeriodicCapture.cpp"
@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariantMap>
+
+/**
+ * Takes a screenshot at a fixed interval until stopped and saves each one without a GUI.
+ *
+ * Grabbing happens on the main thread through the same ImagePlatform used for every other
+ * screenshot, but encoding and writing files is done on a small dedicated thread pool so a
+ * slow disk or a slow format doesn't delay the next capture. The number of frames waiting to
+ * be encoded is bounded. When the backlog is full, new frames are dropped instead of queuing
+ * up an unbounded amount of memory.
+ *
+ * Frames are saved in the image save location using the periodic capture filename template,
+ * which may contain directories (e.g., one per day).
+ */
+class PeriodicCapture : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged FINAL)
+    Q_PROPERTY(int backlog READ backlog NOTIFY statusChanged FINAL)
+
+public:
+    // The largest number of frames that can wait to be encoded at once.
+    static constexpr int maximumBacklog = 4;
+
+    explicit PeriodicCapture(QObject *parent = nullptr);
+    ~PeriodicCapture() override;
+
+    /**
+     * Start requesting a screenshot every `intervalMsec` milliseconds.
+     * When `skipUnchanged` is true, frames that are identical to the previous frame are not saved.
+     * Returns false if periodic capture can't be used with the current settings.
+     */
+    bool start(int intervalMsec, bool skipUnchanged);
+
+    /**
+     * Stop requesting screenshots. Frames that are already queued are still saved.
+     */
+    void stop();
+
+    bool isActive() const;
+    int interval() const;
+    int backlog() const;
+
+    /**
+     * Whether no captures have been requested and no frames are waiting to be saved.
+     */
+    bool isIdle() const;
+
+    /**
+     * Whether a screenshot was requested with grabRequested() and hasn't been received yet.
+     */
+    bool isWaitingForGrab() const;
+
+    /**
+     * Queue a frame taken after grabRequested() was emitted to be saved.
+     * A null image means the grab failed.
+     */
+    void addFrame(const QImage &image);
+
+    /**
+     * Statistics about the current or last run. Times are in milliseconds.
+     */
+    QVariantMap status() const;
+
+Q_SIGNALS:
+    void activeChanged();
+    void statusChanged();
+    /**
+     * Emitted when it is time to take a new screenshot.
+     */
+    void grabRequested();
+    /**
+     * Emitted after a frame has been written.
+     * `captureCost` is the time between requesting the screenshot and receiving it.
+     * `encodeCost` is the time spent encoding and writing the file.
+     */
+    void frameSaved(const QString &fileName, int captureCost, int encodeCost, int backlog);
+    void frameFailed(const QString &message);
+    /**
+     * Emitted when stopped and every queued frame has been saved.
+     */
+    void finished();
+
+private:
+    void requestGrab();
+    QString nextFilePath(const QImage &image, const QDateTime &timestamp);
+    void checkFinished();
+
+    QTimer m_timer;
+    QThreadPool m_pool;
+    QElapsedTimer m_grabTimer;
+    QSet<QString> m_pendingPaths;
+    size_t m_lastHash = 0;
+    QImage m_lastFrame;
+    bool m_skipUnchanged = false;
+    bool m_waitingForGrab = false;
+    int m_backlog = 0;
+    int m_received = 0;
+    int m_saved = 0;
+    int m_skipped = 0;
+    int m_dropped = 0;
+    int m_failed = 0;
+    qint64 m_lastCaptureCost = 0;
+    qint64 m_lastEncodeCost = 0;
+    qint64 m_totalCaptureCost = 0;
+    qint64 m_totalEncodeCost = 0;
+    QString m_lastFileName;
+};
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "MultiResolutionImage.h"
+
 #include <QFlags>
 #include <QImage>
 #include <QObject>
@@ -54,7 +56,8 @@ Q_SIGNALS:
     void supportedGrabModesChanged();
 
     void newScreenshotTaken(const QImage &image = {});
-    void newCroppableScreenshotTaken(const QImage &image);
+    // Keeps every screen at its own DPR. Only the sections that are shown or exported get resampled.
+    void newCroppableScreenshotTaken(const MultiResolutionImage &image);
 
     void newScreenshotFailed(const QString &message = {});
 };
@@ -7,9 +7,9 @@
 #include "ImagePlatformKWin.h"
 #include "ExportManager.h"
 #include "Geometry.h"
-#include "QtCV.h"
 #include "DebugUtils.h"
 #include "ImageMetaData.h"
+#include "MultiResolutionImage.h"
 
 #include <KWindowSystem>
 
@@ -32,6 +32,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <type_traits>
 #include <unistd.h>
 
 using namespace Qt::StringLiterals;
@@ -61,72 +62,6 @@ static QVariantMap screenShotFlagsToVardict(ImagePlatformKWin::ScreenShotFlags f
     return options;
 }
 
-QImage combinedImage(const QList<QImage> &images)
-{
-    if (images.empty()) {
-        return {};
-    }
-    if (images.size() == 1) {
-        return images.constFirst();
-    }
-    QRectF imageRect;
-    qreal maxDpr = 0;
-    ImageMetaData::SubGeometryList geometryList;
-    for (auto &i : images) {
-        const auto dpr = i.devicePixelRatio();
-        const auto rect = QRectF{ImageMetaData::logicalXY(i), i.deviceIndependentSize()};
-        maxDpr = std::max(maxDpr, dpr);
-        imageRect |= rect;
-        geometryList << ImageMetaData::subGeometryPropertyMap(rect, dpr);
-    }
-    static const auto finalFormat = QImage::Format_RGBA8888_Premultiplied;
-    const bool allSameDpr = std::all_of(images.cbegin(), images.cend(), [maxDpr](const QImage &i){
-        return i.devicePixelRatio() == maxDpr;
-    });
-    if (allSameDpr) {
-        QImage finalImage{imageRect.size().toSize() * maxDpr, finalFormat};
-        QPainter painter(&finalImage);
-        for (auto &image : images) {
-            // Explicitly setting the position and size so that you don't need to read
-            // QPainter source code to understand how this works.
-            painter.drawImage({ImageMetaData::logicalXY(image) * maxDpr, image.size()}, image);
-        }
-        painter.end();
-        // Setting DPR after painting prevents it from affecting the coordinates of the QPainter.
-        // During testing, setting final image DPR first and relying on QPainter::drawImage
-        // automatic scaling would occasionally use the wrong target position. I have no idea why.
-        // It might not even be directly related to QPainter, so keep an eye out for bugs like that.
-        finalImage.setDevicePixelRatio(maxDpr);
-        ImageMetaData::setSubGeometryList(finalImage, geometryList);
-        return finalImage;
-    }
-    // We ceil to the next integer size up so that integer DPR images are always crisp.
-    const auto finalDpr = std::ceil(maxDpr);
-    // An RGBA8888 based format is needed for compatibility with OpenCV.
-    // If we used an ARGB32 based format, we'd need to swap red and blue.
-    // Not sure what to do if we end up having different formats for different screens.
-    QImage finalImage{imageRect.size().toSize() * finalDpr, finalFormat};
-    finalImage.fill(Qt::transparent);
-    auto mainMat = QtCV::qImageToMat(finalImage);
-    for (auto &image : images) {
-        auto rgbaImage = image.format() == finalImage.format() ? image : image.convertedTo(finalFormat);
-        const auto mat = QtCV::qImageToMat(rgbaImage);
-        // Region Of Interest to put the image in the main image.
-        const auto pos = ImageMetaData::logicalXY(rgbaImage) * finalDpr;
-        const auto size = rgbaImage.deviceIndependentSize() * finalDpr;
-        // Truncate to ints instead of rounding to prevent ROI from going out of bounds.
-        const cv::Rect rect(pos.x(), pos.y(), size.width(), size.height());
-        const auto imageDpr = image.devicePixelRatio();
-        const bool hasIntDpr = static_cast<int>(imageDpr) == imageDpr;
-        const auto interpolation = hasIntDpr ? cv::INTER_AREA : cv::INTER_LANCZOS4;
-        // Will just copy if there's no difference in size
-        cv::resize(mat, mainMat(rect), rect.size(), 0, 0, interpolation);
-    }
-    finalImage.setDevicePixelRatio(finalDpr);
-    ImageMetaData::setSubGeometryList(finalImage, geometryList);
-    return finalImage;
-}
-
 static ResultVariant allocateImage(const QVariantMap &metadata)
 {
     QString errors;
@@ -489,7 +424,12 @@ void ImagePlatformKWin::trackSource(ScreenShotSourceMeta2 *source, OutputSignal
         }
 
         if (!images.empty()) {
-            Q_EMIT (this->*outputSignal)(combinedImage(images));
+            const MultiResolutionImage image(images);
+            if constexpr (std::is_invocable_v<OutputSignal, ImagePlatform *, const MultiResolutionImage &>) {
+                Q_EMIT (this->*outputSignal)(image);
+            } else {
+                Q_EMIT (this->*outputSignal)(image.toImage());
+            }
         }
         if (!errorString.isEmpty()) {
             Q_EMIT newScreenshotFailed(errorString);
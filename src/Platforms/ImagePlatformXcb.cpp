@@ -494,7 +494,7 @@ void ImagePlatformXcb::grabAllScreens(bool includePointer, bool crop)
     auto image = getToplevelImage(QRect(), includePointer);
     image.setDevicePixelRatio(qGuiApp->devicePixelRatio());
     if (crop) {
-        Q_EMIT newCroppableScreenshotTaken(image);
+        Q_EMIT newCroppableScreenshotTaken(MultiResolutionImage({image}));
         return;
     }
     Q_EMIT newScreenshotTaken(image);
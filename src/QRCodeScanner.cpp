@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "QRCodeScanner.h"
+
+#include <Prison/ImageScanner>
+#include <Prison/ScanResult>
+#include <QtConcurrent/QtConcurrentRun>
+
+QRCodeScanner::QRCodeScanner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QVariant QRCodeScanner::scanImage(const QImage &image)
+{
+    const auto result = Prison::ImageScanner::scan(image);
+    if (result.hasText()) {
+        return result.text();
+    } else if (result.hasBinaryData()) {
+        return result.binaryData();
+    }
+    return {};
+}
+
+void QRCodeScanner::scan(const QImage &image, quint64 revision)
+{
+    if (image.isNull()) {
+        return;
+    }
+    const Key key{image.cacheKey(), revision};
+    if (key == m_key && m_future.isValid() && !m_future.isCanceled()) {
+        if (m_future.isFinished()) {
+            if (const auto content = m_future.result(); !content.isNull()) {
+                Q_EMIT scanned(content);
+            }
+        }
+        // Otherwise, the scan in progress emits the result when it is done.
+        return;
+    }
+    cancel();
+    m_key = key;
+    // The worker thread gets its own reference to the image, so replacing the image being
+    // exported doesn't affect it.
+    m_future = QtConcurrent::run(&QRCodeScanner::scanImage, image);
+    m_future.then(this, [this, key](const QVariant &content) {
+        if (key != m_key || content.isNull()) {
+            return;
+        }
+        Q_EMIT scanned(content);
+    });
+}
+
+void QRCodeScanner::cancel()
+{
+    // Only prevents a scan that hasn't started yet. The result of a running one is ignored.
+    m_future.cancel();
+    m_future = {};
+    m_key = {};
+}
+
+#include "moc_QRCodeScanner.cpp"
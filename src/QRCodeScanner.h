@@ -0,0 +1,54 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QFuture>
+#include <QImage>
+#include <QObject>
+#include <QVariant>
+
+/**
+ * Scans images for QR codes on a worker thread, at most once per image.
+ *
+ * Results are kept for the image with the cache key and annotation revision of the last scan,
+ * so asking again for the same capture emits the result right away instead of scanning again.
+ * Scanning another image or calling cancel() cancels the previous scan if it hasn't started yet
+ * and drops its result otherwise, since a scan that has started can't be interrupted.
+ */
+class QRCodeScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QRCodeScanner(QObject *parent = nullptr);
+
+    /**
+     * Scan the image unless it is already being scanned or was scanned with the same revision.
+     * scanned() is emitted when a code is found, even when the result was already known.
+     */
+    void scan(const QImage &image, quint64 revision = 0);
+
+    /**
+     * Cancel the scan in progress and forget the last result.
+     */
+    void cancel();
+
+Q_SIGNALS:
+    void scanned(const QVariant &content);
+
+private:
+    struct Key {
+        qint64 cacheKey = 0;
+        quint64 revision = 0;
+        bool operator==(const Key &other) const = default;
+    };
+
+    // Text or binary data of the code found in the image or null if there wasn't one.
+    static QVariant scanImage(const QImage &image);
+
+    Key m_key;
+    // The scan of the image with m_key.
+    QFuture<QVariant> m_future;
+};
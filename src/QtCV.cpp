@@ -0,0 +1,146 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "QtCV.h"
+
+#include <QList>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <atomic>
+#include <numeric>
+#include <utility>
+
+// Tiles smaller than this take longer to set up than to blur.
+static constexpr int minimumTileRows = 64;
+
+static std::atomic_int s_conversionCount = 0;
+
+// The parallel backend API is unavailable in OpenCV versions before 4.5.2.
+#if __has_include(<opencv2/core/parallel/parallel_backend.hpp>)
+#include <opencv2/core/parallel/parallel_backend.hpp>
+
+// The chunk the current thread is running, for cv::getThreadNum().
+static thread_local int s_threadNum = 0;
+
+class ThreadPoolBackend : public cv::parallel::ParallelForAPI
+{
+public:
+    void parallel_for(int tasks, FN_parallel_for_body_cb_t bodyCallback, void *callbackData) override
+    {
+        auto pool = QThreadPool::globalInstance();
+        const int chunkCount = std::min(tasks, m_numThreads);
+        // Waiting on the pool from one of its threads would only take threads from other tasks.
+        if (chunkCount <= 1 || pool->contains(QThread::currentThread())) {
+            bodyCallback(0, tasks, callbackData);
+            return;
+        }
+        QList<int> chunks(chunkCount);
+        std::iota(chunks.begin(), chunks.end(), 0);
+        // The calling thread runs chunks too instead of only waiting.
+        QtConcurrent::blockingMap(pool, chunks, [&](const int &chunk) {
+            const int start = qsizetype(tasks) * chunk / chunkCount;
+            const int end = qsizetype(tasks) * (chunk + 1) / chunkCount;
+            const int oldThreadNum = std::exchange(s_threadNum, chunk);
+            bodyCallback(start, end, callbackData);
+            s_threadNum = oldThreadNum;
+        });
+    }
+
+    int getThreadNum() const override
+    {
+        return s_threadNum;
+    }
+
+    int getNumThreads() const override
+    {
+        return m_numThreads;
+    }
+
+    int setNumThreads(int numThreads) override
+    {
+        // Like OpenCV, 0 or less means the default.
+        return std::exchange(m_numThreads, numThreads > 0 ? numThreads : QThreadPool::globalInstance()->maxThreadCount());
+    }
+
+    const char *getName() const override
+    {
+        return "QThreadPool";
+    }
+
+private:
+    int m_numThreads = QThreadPool::globalInstance()->maxThreadCount();
+};
+#endif
+
+void QtCV::convertTo(QImage &image, QImage::Format format)
+{
+    if (image.isNull() || image.format() == format) {
+        return;
+    }
+    ++s_conversionCount;
+    image.convertTo(format);
+}
+
+QImage QtCV::convertedTo(const QImage &image, QImage::Format format)
+{
+    if (image.isNull() || image.format() == format) {
+        return image;
+    }
+    ++s_conversionCount;
+    return image.convertedTo(format);
+}
+
+int QtCV::conversionCount()
+{
+    return s_conversionCount;
+}
+
+void QtCV::resetConversionCount()
+{
+    s_conversionCount = 0;
+}
+
+void QtCV::initializeThreading()
+{
+#if __has_include(<opencv2/core/parallel/parallel_backend.hpp>)
+    cv::parallel::setParallelForBackend(std::make_shared<ThreadPoolBackend>());
+#else
+    // At least don't use more threads than QThreadPool.
+    cv::setNumThreads(QThreadPool::globalInstance()->maxThreadCount());
+#endif
+}
+
+void QtCV::parallelStackOrGaussianBlur(const cv::Mat &in, cv::Mat &out, double sigmaX, double sigmaY)
+{
+    if (sigmaY <= 0) {
+        sigmaY = sigmaX;
+    }
+    const int tileCount = std::min(cv::getNumThreads(), in.rows / minimumTileRows);
+    if (tileCount <= 1) {
+        stackOrGaussianBlurCompatibility(in, out, {}, sigmaX, sigmaY);
+        return;
+    }
+    // Same kernel height as stackOrGaussianBlurCompatibility with automatic kernel sizes.
+    const auto gaussianKSizeFactor = (in.depth() == CV_8U ? 3 : 4) * 2;
+    const int halo = sigmaToKSize(sigmaY * gaussianKSizeFactor) / 2 + 1;
+    // Tiles read rows that other tiles write, so they can't blur in place.
+    const cv::Mat source = in.data == out.data ? in.clone() : in;
+    out.create(in.size(), in.type());
+    cv::parallel_for_(
+        cv::Range(0, tileCount),
+        [&](const cv::Range &range) {
+            for (int tile = range.start; tile < range.end; ++tile) {
+                const int first = qsizetype(in.rows) * tile / tileCount;
+                const int last = qsizetype(in.rows) * (tile + 1) / tileCount;
+                const int haloFirst = std::max(0, first - halo);
+                const int haloLast = std::min(in.rows, last + halo);
+                cv::Mat blurred;
+                stackOrGaussianBlurCompatibility(source.rowRange(haloFirst, haloLast), blurred, {}, sigmaX, sigmaY);
+                blurred.rowRange(first - haloFirst, last - haloFirst).copyTo(out.rowRange(first, last));
+            }
+        },
+        tileCount);
+}
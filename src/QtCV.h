@@ -9,9 +9,45 @@
 
 /**
  * Convenience functions for using OpenCV with Qt APIs.
+ *
+ * Threading:
+ * OpenCV normally starts its own pool of threads, one per core, next to QThreadPool's one per core.
+ * initializeThreading() makes cv::parallel_for_ run on QThreadPool::globalInstance() instead, so
+ * the whole process shares one pool. Calls made from a pool thread (QtConcurrent tasks) run on that
+ * thread alone instead of competing for the pool with the task that called them.
+ *
+ * Paths using the shared pool:
+ * - cv::resize and cv::cvtColor already split their work with cv::parallel_for_, so combining
+ *   screens (MultiResolutionImage) and image comparison (ImageDiff) get it through the backend.
+ * - Blur effects use parallelStackOrGaussianBlur(), which splits the image into tiles because
+ *   Gaussian blur isn't split up by OpenCV.
+ * - Screenshot index hashing and banded annotation painting already run on pool threads,
+ *   so the OpenCV calls they make stay on those threads.
  */
 namespace QtCV
 {
+/**
+ * The pixel format used for images from capture to export.
+ *
+ * Premultiplied because that's what QPainter is fastest with and RGBA byte order because OpenCV can
+ * use the pixels without swapping red and blue. Images are converted to it once when they enter
+ * Spectacle, so that annotating, effects and OpenCV don't need to convert them again.
+ * Converting a full screen 8K image takes tens of milliseconds.
+ */
+inline constexpr auto workingFormat = QImage::Format_RGBA8888_Premultiplied;
+
+// Convert the image in place if it doesn't already have the format.
+// Only actual conversions are counted by conversionCount().
+void convertTo(QImage &image, QImage::Format format = workingFormat);
+
+// Same as above, but returns a converted copy.
+QImage convertedTo(const QImage &image, QImage::Format format = workingFormat);
+
+// The number of conversions done with convertTo() or convertedTo() since the last reset.
+// Used for debugging conversions that could be avoided.
+int conversionCount();
+void resetConversionCount();
+
 static constexpr int INVALID_MAT_TYPE = -1;
 static_assert(CV_8U == 0);
 static_assert(std::same_as<decltype(CV_8U), int>);
@@ -89,6 +125,15 @@ inline void stackOrGaussianBlurCompatibility(cv::InputArray &in, cv::OutputArray
     cv::GaussianBlur(in, out, ksize, sigmaX, sigmaY, borderType);
 #endif
 }
+
+// Make OpenCV use QThreadPool::globalInstance() for its parallel loops.
+// Call once after creating the application.
+void initializeThreading();
+
+// Same as stackOrGaussianBlurCompatibility with automatic kernel sizes, but with the image split
+// into horizontal tiles that are blurred in parallel. Every tile reads enough rows around itself to
+// give the same result as blurring the whole image at once. `in` and `out` may be the same.
+void parallelStackOrGaussianBlur(const cv::Mat &in, cv::Mat &out, double sigmaX, double sigmaY = 0);
 }
 
 
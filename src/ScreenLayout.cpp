@@ -0,0 +1,111 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "ScreenLayout.h"
+#include "Geometry.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+
+class ScreenLayoutSingleton
+{
+public:
+    ScreenLayout self;
+};
+
+Q_GLOBAL_STATIC(ScreenLayoutSingleton, privateScreenLayoutSelf)
+
+ScreenLayout::ScreenLayout(QObject *parent)
+    : QObject(parent)
+{
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
+        watchScreen(screen);
+        update();
+    });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, &ScreenLayout::update);
+    const auto screens = qGuiApp->screens();
+    for (auto screen : screens) {
+        watchScreen(screen);
+    }
+    update();
+}
+
+ScreenLayout *ScreenLayout::instance()
+{
+    return &privateScreenLayoutSelf->self;
+}
+
+void ScreenLayout::watchScreen(QScreen *screen)
+{
+    connect(screen, &QScreen::geometryChanged, this, &ScreenLayout::update);
+    // There is no signal for the device pixel ratio, but it changes with the DPI.
+    connect(screen, &QScreen::physicalDotsPerInchChanged, this, &ScreenLayout::update);
+}
+
+void ScreenLayout::update()
+{
+    QList<Screen> screens;
+    QRectF platformUnifiedRect;
+    const auto &qScreens = qGuiApp->screens();
+    screens.reserve(qScreens.size());
+    for (auto screen : qScreens) {
+        const auto dpr = screen->devicePixelRatio();
+        const auto rect = screen->geometry();
+        screens.append({screen, rect, Geometry::mapFromPlatformRect(rect, dpr), dpr});
+        platformUnifiedRect |= rect;
+    }
+    // The union is mapped with the application DPR, which is the largest one.
+    const auto devicePixelRatio = qGuiApp->devicePixelRatio();
+    QRectF logicalScreensRect;
+    for (const auto &screen : std::as_const(screens)) {
+        logicalScreensRect |= Geometry::mapFromPlatformRect(screen.platformRect, devicePixelRatio);
+    }
+
+    // Individual screens can change without changing the unions.
+    const bool changed = !std::ranges::equal(screens, m_screens, [](const Screen &lhs, const Screen &rhs) {
+        return lhs.screen == rhs.screen && lhs.platformRect == rhs.platformRect && lhs.devicePixelRatio == rhs.devicePixelRatio;
+    }) || devicePixelRatio != m_devicePixelRatio;
+    if (!changed) {
+        return;
+    }
+    m_screens = screens;
+    m_logicalScreensRect = logicalScreensRect;
+    m_platformUnifiedRect = platformUnifiedRect;
+    m_devicePixelRatio = devicePixelRatio;
+    Q_EMIT layoutChanged();
+}
+
+QList<ScreenLayout::Screen> ScreenLayout::screens() const
+{
+    return m_screens;
+}
+
+QRectF ScreenLayout::logicalScreensRect() const
+{
+    return m_logicalScreensRect;
+}
+
+QRectF ScreenLayout::platformUnifiedRect() const
+{
+    return m_platformUnifiedRect;
+}
+
+qreal ScreenLayout::devicePixelRatio() const
+{
+    return m_devicePixelRatio;
+}
+
+QRectF ScreenLayout::logicalRect(const QScreen *screen) const
+{
+    for (const auto &s : m_screens) {
+        if (s.screen == screen) {
+            return s.logicalRect;
+        }
+    }
+    return {};
+}
+
+#include "moc_ScreenLayout.cpp"
@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QRectF>
+
+class QScreen;
+
+/**
+ * The geometry of all screens, computed once and then only when screens are added or removed or
+ * their geometry changes.
+ *
+ * Geometry::logicalScreensRect() and Geometry::platformUnifiedRect() used to go through every
+ * screen on every call, which adds up when QML bindings use them during drags.
+ * Logical rects are mapped like Geometry::mapFromPlatformRect().
+ */
+class ScreenLayout : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+    /// The union of all logical screen rects.
+    Q_PROPERTY(QRectF logicalScreensRect READ logicalScreensRect NOTIFY layoutChanged FINAL)
+    /// The union of all platform screen rects.
+    Q_PROPERTY(QRectF platformUnifiedRect READ platformUnifiedRect NOTIFY layoutChanged FINAL)
+    /// The largest device pixel ratio of all screens.
+    Q_PROPERTY(qreal devicePixelRatio READ devicePixelRatio NOTIFY layoutChanged FINAL)
+
+public:
+    struct Screen {
+        QPointer<QScreen> screen;
+        QRect platformRect;
+        QRectF logicalRect;
+        qreal devicePixelRatio = 1;
+    };
+
+    static ScreenLayout *instance();
+
+    QList<Screen> screens() const;
+
+    QRectF logicalScreensRect() const;
+
+    QRectF platformUnifiedRect() const;
+
+    qreal devicePixelRatio() const;
+
+    /**
+     * The logical rect of the screen or an empty rect if it isn't known.
+     */
+    Q_INVOKABLE QRectF logicalRect(const QScreen *screen) const;
+
+    static ScreenLayout *create(QQmlEngine *engine, QJSEngine *)
+    {
+        auto inst = instance();
+        Q_ASSERT(inst);
+        Q_ASSERT(inst->thread() == engine->thread());
+        QJSEngine::setObjectOwnership(inst, QJSEngine::CppOwnership);
+        return inst;
+    }
+
+Q_SIGNALS:
+    void layoutChanged();
+
+private:
+    friend class ScreenLayoutSingleton;
+    explicit ScreenLayout(QObject *parent = nullptr);
+
+    void watchScreen(QScreen *screen);
+    void update();
+
+    QList<Screen> m_screens;
+    QRectF m_logicalScreensRect;
+    QRectF m_platformUnifiedRect;
+    qreal m_devicePixelRatio = 1;
+};
@@ -0,0 +1,338 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "ScreenshotIndex.h"
+#include "DebugUtils.h"
+#include "ImageMetaData.h"
+#include "QtCV.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace Qt::StringLiterals;
+
+static constexpr quint32 fileMagic = 0x53504958; // "SPIX"
+static constexpr quint16 fileVersion = 1;
+static constexpr auto streamVersion = QDataStream::Qt_6_0;
+// Rewriting a big index is only worth it when a lot of it is stale.
+static constexpr qsizetype minimumStaleForCompaction = 1024;
+
+static QDataStream &operator<<(QDataStream &stream, const ScreenshotIndex::Entry &entry)
+{
+    return stream << entry.hash << entry.url << entry.windowTitle << entry.screen << entry.timestamp << entry.size;
+}
+
+static QDataStream &operator>>(QDataStream &stream, ScreenshotIndex::Entry &entry)
+{
+    return stream >> entry.hash >> entry.url >> entry.windowTitle >> entry.screen >> entry.timestamp >> entry.size;
+}
+
+// Returns the generation of the file or 0 if the header isn't valid.
+static quint32 readHeader(QDataStream &stream)
+{
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 generation = 0;
+    stream >> magic >> version >> generation;
+    if (stream.status() != QDataStream::Ok || magic != fileMagic || version != fileVersion) {
+        return 0;
+    }
+    return generation;
+}
+
+static void writeHeader(QDataStream &stream)
+{
+    // A new generation tells other instances that their read offset is no longer valid.
+    stream << fileMagic << fileVersion << std::max(1u, QRandomGenerator::global()->generate());
+}
+
+ScreenshotIndex::ScreenshotIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ScreenshotIndex *ScreenshotIndex::instance()
+{
+    static ScreenshotIndex instance;
+    return &instance;
+}
+
+QString ScreenshotIndex::filePath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + u"/screenshot-index"_s;
+}
+
+quint64 ScreenshotIndex::differenceHash(const QImage &image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+    auto gray = image.convertToFormat(QImage::Format_Grayscale8);
+    cv::Mat small;
+    // Area interpolation averages every source pixel, so the hash doesn't depend on
+    // which pixels a sparse sampling happens to hit.
+    cv::resize(QtCV::qImageToMat(gray), small, {9, 8}, 0, 0, cv::INTER_AREA);
+    quint64 hash = 0;
+    for (int y = 0; y < small.rows; ++y) {
+        const auto row = small.ptr<uchar>(y);
+        for (int x = 0; x < small.cols - 1; ++x) {
+            hash = (hash << 1) | (row[x] < row[x + 1] ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+void ScreenshotIndex::add(const QImage &image, const QUrl &url, const QDateTime &timestamp)
+{
+    if (image.isNull() || !url.isValid()) {
+        return;
+    }
+    Entry entry{0, url, ImageMetaData::windowTitle(image), ImageMetaData::screen(image), timestamp, image.size()};
+    QtConcurrent::run(&ScreenshotIndex::differenceHash, image).then(this, [this, entry](quint64 hash) mutable {
+        entry.hash = hash;
+        append(entry);
+        // Read our own record back along with anything other instances added in the meantime.
+        update();
+    });
+}
+
+QList<ScreenshotIndex::Match> ScreenshotIndex::findSimilar(quint64 hash, int maxDistance)
+{
+    update();
+    QList<Match> results;
+    if (m_nodes.empty()) {
+        return results;
+    }
+    QVarLengthArray<qsizetype, 64> pending{0};
+    while (!pending.isEmpty()) {
+        const auto &node = m_nodes[pending.takeLast()];
+        const int d = distance(node.hash, hash);
+        if (d <= maxDistance) {
+            for (auto index : node.entries) {
+                if (!isLive(index)) {
+                    continue;
+                }
+                const auto &entry = m_entries[index];
+                if (entry.url.isLocalFile() && !QFileInfo::exists(entry.url.toLocalFile())) {
+                    markStale(index);
+                    continue;
+                }
+                results.append({entry, d});
+            }
+        }
+        // By the triangle inequality, matches can only be in children within maxDistance of d.
+        for (const auto &[childDistance, child] : node.children) {
+            if (std::abs(childDistance - d) <= maxDistance) {
+                pending.append(child);
+            }
+        }
+    }
+    std::ranges::sort(results, [](const Match &lhs, const Match &rhs) {
+        return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.entry.timestamp > rhs.entry.timestamp;
+    });
+    compactIfNeeded();
+    return results;
+}
+
+QList<ScreenshotIndex::Match> ScreenshotIndex::findSimilar(const QUrl &url, int maxDistance)
+{
+    update();
+    quint64 hash = 0;
+    if (auto it = m_latest.constFind(url); it != m_latest.cend()) {
+        hash = m_entries[*it].hash;
+    } else if (url.isLocalFile()) {
+        // This QImage constructor only works with local files or Qt resource file names.
+        const QImage image(url.toLocalFile());
+        if (image.isNull()) {
+            return {};
+        }
+        hash = differenceHash(image);
+    } else {
+        return {};
+    }
+    auto results = findSimilar(hash, maxDistance);
+    results.removeIf([&url](const Match &match) {
+        return match.entry.url == url;
+    });
+    return results;
+}
+
+QList<ScreenshotIndex::Entry> ScreenshotIndex::findByWindowTitle(const QString &windowTitle)
+{
+    update();
+    QList<Entry> results;
+    const auto indices = m_byWindowTitle.values(windowTitle);
+    for (auto index : indices) {
+        if (isLive(index)) {
+            results.append(m_entries[index]);
+        }
+    }
+    std::ranges::sort(results, [](const Entry &lhs, const Entry &rhs) {
+        return lhs.timestamp > rhs.timestamp;
+    });
+    return results;
+}
+
+void ScreenshotIndex::update()
+{
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (!m_entries.isEmpty()) {
+            reset(); // Deleted by the user.
+        }
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    const auto generation = readHeader(stream);
+    if (generation == 0) {
+        Log::warning() << "Screenshot index" << file.fileName() << "has an unknown format";
+        return;
+    }
+    if (generation != m_generation || file.size() < m_readOffset) {
+        // Compacted by another instance or replaced.
+        reset();
+        m_generation = generation;
+    }
+    if (m_readOffset > 0) {
+        file.seek(m_readOffset);
+    }
+    while (!stream.atEnd()) {
+        Entry entry;
+        stream >> entry;
+        if (stream.status() != QDataStream::Ok) {
+            // Most likely another instance is in the middle of appending.
+            break;
+        }
+        insert(std::move(entry));
+        m_readOffset = file.pos();
+    }
+}
+
+void ScreenshotIndex::reset()
+{
+    m_nodes.clear();
+    m_entries.clear();
+    m_latest.clear();
+    m_byWindowTitle.clear();
+    m_staleCount = 0;
+    m_generation = 0;
+    m_readOffset = 0;
+}
+
+void ScreenshotIndex::insert(Entry &&entry)
+{
+    const auto index = m_entries.size();
+    if (auto it = m_latest.find(entry.url); it != m_latest.end()) {
+        ++m_staleCount;
+        *it = index;
+    } else {
+        m_latest.insert(entry.url, index);
+    }
+    if (!entry.windowTitle.isEmpty()) {
+        m_byWindowTitle.insert(entry.windowTitle, index);
+    }
+    const auto hash = entry.hash;
+    m_entries.append(std::move(entry));
+
+    if (m_nodes.empty()) {
+        m_nodes.push_back({hash, {index}, {}});
+        return;
+    }
+    std::size_t current = 0;
+    while (true) {
+        auto &node = m_nodes[current];
+        const int d = distance(node.hash, hash);
+        if (d == 0) {
+            node.entries.append(index);
+            return;
+        }
+        const auto it = std::find_if(node.children.cbegin(), node.children.cend(), [d](const auto &child) {
+            return child.first == d;
+        });
+        if (it == node.children.cend()) {
+            // Append the child before push_back() invalidates the node reference.
+            node.children.append({d, qsizetype(m_nodes.size())});
+            m_nodes.push_back({hash, {index}, {}});
+            return;
+        }
+        current = it->second;
+    }
+}
+
+void ScreenshotIndex::append(const Entry &entry)
+{
+    const QFileInfo fileInfo(filePath());
+    if (!QDir().mkpath(fileInfo.path())) {
+        Log::warning() << "Cannot create the directory for the screenshot index" << fileInfo.path();
+        return;
+    }
+    QLockFile lock(fileInfo.filePath() + u".lock"_s);
+    if (!lock.lock()) {
+        return;
+    }
+    QFile file(fileInfo.filePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        Log::warning() << "Cannot open the screenshot index" << file.fileName() << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    if (file.size() == 0) {
+        writeHeader(stream);
+    }
+    stream << entry;
+}
+
+bool ScreenshotIndex::isLive(qsizetype index) const
+{
+    return m_latest.value(m_entries[index].url, -1) == index;
+}
+
+void ScreenshotIndex::markStale(qsizetype index)
+{
+    m_latest.remove(m_entries[index].url);
+    ++m_staleCount;
+}
+
+void ScreenshotIndex::compactIfNeeded()
+{
+    if (m_staleCount < minimumStaleForCompaction || m_staleCount < m_latest.size()) {
+        return;
+    }
+    QLockFile lock(filePath() + u".lock"_s);
+    if (!lock.tryLock()) {
+        return; // Try again next time.
+    }
+    // Don't drop records another instance appended since the last update.
+    update();
+    QSaveFile file(filePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    writeHeader(stream);
+    for (qsizetype i = 0; i < m_entries.size(); ++i) {
+        if (isLive(i)) {
+            stream << m_entries[i];
+        }
+    }
+    if (file.commit()) {
+        reset();
+        update();
+    }
+}
+
+#include "moc_ScreenshotIndex.cpp"
@@ -0,0 +1,118 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QSize>
+#include <QUrl>
+#include <QVarLengthArray>
+
+#include <bit>
+#include <vector>
+
+/**
+ * An on-disk index of perceptual hashes of saved screenshots.
+ *
+ * Every screenshot saved by ExportManager is reduced to a 64 bit difference hash (dHash) on a
+ * worker thread and appended to a small binary file together with its URL, window title, screen,
+ * size and timestamp. Images that look alike have hashes that differ in only a few bits, so
+ * near-duplicates can be found without decoding any of the saved files again.
+ *
+ * Lookups use a BK-tree over the Hamming distance, which skips every subtree that can't contain a
+ * match. The file is only ever appended to, so several Spectacle instances can share it. Records
+ * written by other instances are picked up before each lookup.
+ */
+class ScreenshotIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        quint64 hash = 0;
+        QUrl url;
+        QString windowTitle;
+        QString screen;
+        QDateTime timestamp;
+        QSize size;
+    };
+
+    struct Match {
+        Entry entry;
+        int distance = 0;
+    };
+
+    // Good enough to find the same content after lossy compression, scaling or small changes
+    // like a blinking cursor, without matching unrelated images that share a layout.
+    static constexpr int defaultMaxDistance = 6;
+
+    static ScreenshotIndex *instance();
+
+    /**
+     * The 64 bit difference hash of the image: the brightness gradient of a 9x8 thumbnail.
+     */
+    static quint64 differenceHash(const QImage &image);
+
+    static int distance(quint64 lhs, quint64 rhs)
+    {
+        return std::popcount(lhs ^ rhs);
+    }
+
+    /**
+     * Hash the image in the background and add it to the index.
+     * An earlier entry with the same URL is replaced.
+     */
+    void add(const QImage &image, const QUrl &url, const QDateTime &timestamp);
+
+    /**
+     * Entries with a hash within `maxDistance` bits of `hash`,
+     * sorted by distance and then from newest to oldest.
+     */
+    QList<Match> findSimilar(quint64 hash, int maxDistance = defaultMaxDistance);
+
+    /**
+     * Same as above, but uses the indexed hash of the file if there is one instead of decoding it.
+     * The file itself is not included in the results.
+     */
+    QList<Match> findSimilar(const QUrl &url, int maxDistance = defaultMaxDistance);
+
+    /**
+     * Entries of screenshots of windows with the given title, from newest to oldest.
+     */
+    QList<Entry> findByWindowTitle(const QString &windowTitle);
+
+    QString filePath() const;
+
+private:
+    explicit ScreenshotIndex(QObject *parent = nullptr);
+
+    struct Node {
+        quint64 hash = 0;
+        // Indices in m_entries. More than one when images have the same hash.
+        QVarLengthArray<qsizetype, 1> entries;
+        // Pairs of distance to this node and index in m_nodes.
+        QVarLengthArray<std::pair<int, qsizetype>, 4> children;
+    };
+
+    void update();
+    void reset();
+    void insert(Entry &&entry);
+    void append(const Entry &entry);
+    bool isLive(qsizetype index) const;
+    void markStale(qsizetype index);
+    void compactIfNeeded();
+
+    std::vector<Node> m_nodes;
+    QList<Entry> m_entries;
+    // The latest entry for every URL. Entries that aren't in here are stale.
+    QHash<QUrl, qsizetype> m_latest;
+    QMultiHash<QString, qsizetype> m_byWindowTitle;
+    qsizetype m_staleCount = 0;
+    quint32 m_generation = 0;
+    qint64 m_readOffset = 0;
+};
@@ -10,6 +10,9 @@
 #include "CommandLineOptions.h"
 #include "ExportManager.h"
 #include "Geometry.h"
+#include "ImageMetaData.h"
+#include "ScreenLayout.h"
+#include "ImageDiff.h"
 #include "Gui/Annotations/AnnotationViewport.h"
 #include "Gui/Annotations/QmlPainterPath.h"
 #include "Gui/CaptureWindow.h"
@@ -23,6 +26,7 @@
 #include "Platforms/VideoPlatform.h"
 #include "ShortcutActions.h"
 #include "PlasmaVersion.h"
+#include "QtCV.h"
 // generated
 #include "Config.h"
 #include "settings.h"
@@ -44,9 +48,11 @@
 #include <QClipboard>
 #include <QCommandLineParser>
 #include <QDBusConnection>
+#include <QDBusConnectionInterface>
 #include <QDBusMessage>
 #include <QDir>
 #include <QDrag>
+#include <QImageReader>
 #include <QKeySequence>
 #include <QMimeData>
 #include <QMovie>
@@ -57,7 +63,9 @@
 #include <QScopedPointer>
 #include <QScreen>
 #include <QSystemTrayIcon>
+#include <QTextStream>
 #include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtMath>
 #include <qobject.h>
 #include <qobjectdefs.h>
@@ -67,6 +75,16 @@ using namespace Qt::StringLiterals;
 SpectacleCore *SpectacleCore::s_self = nullptr;
 static std::unique_ptr<KStatusNotifierItem> s_systemTrayIcon;
 
+// How long to keep the copied image on the clipboard when nothing takes it over before quitting.
+static constexpr int clipboardOwnerTimeout = 5000;
+
+// Without a clipboard manager, nothing takes over the copied image, so there is no point in waiting.
+static bool hasClipboardManager()
+{
+    const auto interface = QDBusConnection::sessionBus().interface();
+    return interface && interface->isServiceRegistered(u"org.kde.klipper"_s);
+}
+
 SpectacleCore::SpectacleCore(QObject *parent)
     : QObject(parent)
 {
@@ -75,6 +93,25 @@ SpectacleCore::SpectacleCore(QObject *parent)
     m_annotationSyncTimer->setInterval(400);
     m_annotationSyncTimer->setSingleShot(true);
 
+    // Timer to wait for the user to stop editing before encoding ahead of time.
+    // Longer than the annotation sync so that the image it renders can be reused.
+    m_speculativeExportTimer = std::make_unique<QTimer>();
+    m_speculativeExportTimer->setInterval(1000);
+    m_speculativeExportTimer->setSingleShot(true);
+
+    // Timer to stop waiting for a clipboard manager to take over the copied image before quitting.
+    // Whichever comes first finishes, so allDone is only emitted once.
+    m_clipboardOwnerTimer = std::make_unique<QTimer>();
+    m_clipboardOwnerTimer->setInterval(clipboardOwnerTimeout);
+    m_clipboardOwnerTimer->setSingleShot(true);
+    connect(m_clipboardOwnerTimer.get(), &QTimer::timeout, this, &SpectacleCore::allDone);
+    connect(ExportManager::instance(), &ExportManager::clipboardImageReleased, this, [this] {
+        if (m_clipboardOwnerTimer->isActive()) {
+            m_clipboardOwnerTimer->stop();
+            Q_EMIT allDone();
+        }
+    });
+
     m_delayAnimation = std::make_unique<QVariantAnimation>(this);
     m_delayAnimation->setStartValue(0.0);
     m_delayAnimation->setEndValue(1.0);
@@ -110,7 +147,7 @@ SpectacleCore::SpectacleCore(QObject *parent)
         }
     };
     auto onFinished = [this]() {
-        m_imagePlatform->doGrab(ImagePlatform::ShutterMode::Immediate, m_lastGrabMode, m_lastIncludePointer, m_lastIncludeDecorations, m_lastIncludeShadow);
+        doGrab(ImagePlatform::ShutterMode::Immediate);
     };
     QObject::connect(delayAnimation, &QVariantAnimation::stateChanged,
                      this, onStateChanged, Qt::QueuedConnection);
@@ -123,6 +160,8 @@ SpectacleCore::SpectacleCore(QObject *parent)
     m_videoPlatform = loadVideoPlatform();
     auto imagePlatform = m_imagePlatform.get();
     m_annotationDocument = std::make_unique<AnnotationDocument>();
+    m_burstCapture = std::make_unique<BurstCapture>();
+    m_periodicCapture = std::make_unique<PeriodicCapture>();
 
     // essential connections
     connect(SelectionEditor::instance(), &SelectionEditor::accepted,
@@ -158,28 +197,106 @@ SpectacleCore::SpectacleCore(QObject *parent)
             m_videoPlatform->startRecording(output, VideoPlatform::Region, {{rectKey, rect}}, includePointer);
         } else {
             deleteWindows();
+            // Use the speculative render if nothing changed since it was made.
+            const bool speculated = !m_speculativeExport.image.isNull() //
+                && m_speculativeExport.revision == m_annotationDocument->revision() //
+                && m_speculativeExport.cropRect == rect;
+            m_speculativeExport.accepted = speculated;
             m_annotationDocument->cropCanvas(rect);
-            syncExportImage();
+            if (speculated) {
+                setExportImage(m_speculativeExport.image);
+            } else {
+                syncExportImage();
+            }
+            // Only the GUI has an editor that can undo the crop. Don't check isGuiNull() here,
+            // the capture windows were already deleted, so it's always true at this point.
+            if (m_startMode != StartMode::Gui) {
+                m_annotationDocument->releaseUncroppedBaseImage();
+            }
             showViewerIfGuiMode();
             SpectacleWindow::setTitleForAll(SpectacleWindow::Unsaved);
-            ExportManager::instance()->scanQRCode();
+            if (ViewerWindow::instance()) {
+                ExportManager::instance()->scanQRCode(m_annotationDocument->revision());
+            } else {
+                ExportManager::instance()->cancelQRCodeScan();
+            }
             const auto &exportActions = actions & ExportManager::AnyAction ? actions : autoExportActions();
             ExportManager::instance()->exportImage(exportActions, outputUrl());
+            if (m_startMode == StartMode::Gui && !ExportManager::instance()->isImageSavedNotInTemp()) {
+                // Like screenshots that don't need a selection. Reuses the speculative encode if there is one.
+                ExportManager::instance()->preEncode();
+            }
+            m_speculativeExport = {};
         }
     });
 
-    connect(imagePlatform, &ImagePlatform::newScreenshotTaken, this, [this](const QImage &image){
+    auto onNewScreenshotTaken = [this](const QImage &capturedImage) {
+        // Convert once here instead of every time annotations, effects or OpenCV need the pixels.
+        const auto image = QtCV::convertedTo(capturedImage);
+        Log::debug() << "Pixel format conversions for this screenshot:" << QtCV::conversionCount();
         m_annotationDocument->clearAnnotations();
         m_annotationDocument->setBaseImage(image);
         setExportImage(image);
         ExportManager::instance()->updateTimestamp();
         showViewerIfGuiMode();
         SpectacleWindow::setTitleForAll(SpectacleWindow::Unsaved);
-        ExportManager::instance()->scanQRCode();
-        ExportManager::instance()->exportImage(autoExportActions(), outputUrl());
+        if (ViewerWindow::instance()) {
+            // Only the viewer shows scanned codes. Pending scans would also keep us from quitting.
+            ExportManager::instance()->scanQRCode(m_annotationDocument->revision());
+        } else {
+            ExportManager::instance()->cancelQRCodeScan();
+        }
+        auto exportScreenshot = [this] {
+            ExportManager::instance()->exportImage(autoExportActions(), outputUrl());
+            if (m_startMode == StartMode::Gui && !ExportManager::instance()->isImageSavedNotInTemp()) {
+                // Opening the screenshot in another application or sharing it
+                // needs a file, so have it ready before it is asked for.
+                ExportManager::instance()->preEncode();
+            }
+        };
+        if (!m_compareUrl.isEmpty()) {
+            // Export when the comparison is done so that the differences are in the exported image.
+            startComparison(m_compareUrl, exportScreenshot);
+        } else {
+            exportScreenshot();
+        }
         setVideoMode(false);
+    };
+    connect(imagePlatform, &ImagePlatform::newScreenshotTaken, this, [this, onNewScreenshotTaken](const QImage &image) {
+        if (takeGrabRequester() == GrabRequester::PeriodicCapture) {
+            m_periodicCapture->addFrame(image);
+            return;
+        }
+        if (!m_burstCapture->isActive()) {
+            onNewScreenshotTaken(image);
+            return;
+        }
+        m_burstCapture->addFrame(image);
+        if (m_burstCapture->isActive()) {
+            QTimer::singleShot(m_burstCapture->interval(), this, [this] {
+                if (!m_burstCapture->isActive()) {
+                    return; // canceled while waiting
+                }
+                doGrab(ImagePlatform::ShutterMode::Immediate);
+            });
+            return;
+        }
+        if (m_startMode != StartMode::Gui) {
+            // Without a GUI to pick frames from, save all of them.
+            setVideoMode(false);
+            const auto url = m_burstCapture->exportAll();
+            if (m_cliOptions[CommandLineOptions::NoNotify]) {
+                Q_EMIT allDone();
+            } else {
+                doNotify(ScreenCapture::Screenshot, ExportManager::Save, url);
+            }
+            return;
+        }
+        onNewScreenshotTaken(m_burstCapture->lastFrame());
     });
-    connect(imagePlatform, &ImagePlatform::newCroppableScreenshotTaken, this, [this](const QImage &image) {
+    connect(imagePlatform, &ImagePlatform::newCroppableScreenshotTaken, this, [this](const MultiResolutionImage &image) {
+        takeGrabRequester();
+        Log::debug() << "Pixel format conversions for this screenshot:" << QtCV::conversionCount();
         setVideoMode(false);
         m_annotationDocument->clearAnnotations();
         m_annotationDocument->setBaseImage(image);
@@ -233,7 +350,15 @@ SpectacleCore::SpectacleCore(QObject *parent)
         }
         }
     };
-    connect(imagePlatform, &ImagePlatform::newScreenshotFailed, this, [onScreenshotOrRecordingFailed](const QString message) {
+    connect(imagePlatform, &ImagePlatform::newScreenshotFailed, this, [this, onScreenshotOrRecordingFailed](const QString message) {
+        if (takeGrabRequester() == GrabRequester::PeriodicCapture) {
+            // A single failed grab shouldn't end a capture that may run for hours.
+            Log::warning() << "Periodic capture: screenshot failed:" << message;
+            m_periodicCapture->addFrame({});
+            return;
+        }
+        m_burstCapture->cancel();
+        discardPreparedCaptureWindows();
         auto uiMessage = i18nc("@info", "An error occurred while taking a screenshot.");
         onScreenshotOrRecordingFailed(message, uiMessage, &SpectacleCore::dbusScreenshotFailed, &ViewerWindow::showScreenshotFailedMessage);
     });
@@ -334,6 +459,13 @@ SpectacleCore::SpectacleCore(QObject *parent)
     // set up the export manager
     auto exportManager = ExportManager::instance();
     auto onImageExported = [this](const ExportManager::Actions &actions, const QUrl &url) {
+        if (m_burstCapture->isExporting()) {
+            // Handled once for all frames when the burst export is finished.
+            // The D-Bus ScreenshotTaken signal is still emitted for every frame
+            // since it is connected to imageExported directly.
+            return;
+        }
+
         if (actions & ExportManager::UserAction && Settings::quitAfterSaveCopyExport()) {
             deleteWindows();
         }
@@ -342,10 +474,11 @@ SpectacleCore::SpectacleCore(QObject *parent)
             if (m_cliOptions[CommandLineOptions::NoNotify]) {
                 // if we notify, we Q_EMIT allDone only if the user either dismissed the notification or pressed
                 // the "Open" button, otherwise the app closes before it can react to it.
-                if (actions & ExportManager::CopyImage) {
-                    // Allow some time for clipboard content to transfer if '--nonotify' is used, see Bug #411263
-                    // TODO: Find better solution
-                    QTimer::singleShot(250, this, &SpectacleCore::allDone);
+                auto exportManager = ExportManager::instance();
+                if (actions & ExportManager::CopyImage && exportManager->ownsClipboardImage() && hasClipboardManager()) {
+                    // The copied image is gone once we quit, so stay around until a clipboard
+                    // manager like Klipper takes it over, but not forever, see Bug #411263
+                    m_clipboardOwnerTimer->start();
                 } else {
                     Q_EMIT allDone();
                 }
@@ -374,6 +507,20 @@ SpectacleCore::SpectacleCore(QObject *parent)
         }
     };
     connect(exportManager, &ExportManager::imageExported, this, onImageExported);
+    connect(m_periodicCapture.get(), &PeriodicCapture::grabRequested, this, [this] {
+        doGrab(ImagePlatform::ShutterMode::Immediate, GrabRequester::PeriodicCapture);
+    });
+    connect(m_periodicCapture.get(), &PeriodicCapture::finished, this, [this] {
+        if (m_startMode != StartMode::Gui || isGuiNull()) {
+            Q_EMIT allDone();
+        }
+    });
+    connect(m_burstCapture.get(), &BurstCapture::framesExported, this, [](const QUrl &lastUrl) {
+        if (auto viewerWindow = ViewerWindow::instance()) {
+            SpectacleWindow::setTitleForAll(SpectacleWindow::Saved, lastUrl.fileName());
+            viewerWindow->showSavedMessage(lastUrl);
+        }
+    });
     auto onVideoExported = [this](const ExportManager::Actions &actions, const QUrl &url) {
         setCurrentVideo(url);
 
@@ -422,8 +569,22 @@ SpectacleCore::SpectacleCore(QObject *parent)
     connect(exportManager, &ExportManager::errorMessage, this, &SpectacleCore::showErrorMessage);
 
     connect(m_annotationDocument.get(), &AnnotationDocument::repaintNeeded, m_annotationSyncTimer.get(), qOverload<>(&QTimer::start));
+    connect(m_annotationDocument.get(), &AnnotationDocument::repaintNeeded, this, [this] {
+        // The export image is going to change, so a speculative encode of it would be wasted.
+        if (!m_speculativeExport.accepted) {
+            ExportManager::instance()->discardPreEncoded();
+        }
+        m_speculativeExportTimer->start();
+    });
+    connect(SelectionEditor::instance()->selection(), &Selection::rectChanged, m_speculativeExportTimer.get(), qOverload<>(&QTimer::start));
+    connect(m_speculativeExportTimer.get(), &QTimer::timeout, this, &SpectacleCore::speculateExport);
     connect(m_annotationSyncTimer.get(), &QTimer::timeout, this, [this] {
+        if (m_imageLoading) {
+            return; // Don't export a preview.
+        }
+        const auto revision = m_annotationDocument->revision();
         ExportManager::instance()->setImage(m_annotationDocument->renderToImage());
+        m_exportImageRevision = revision;
     }, Qt::QueuedConnection); // QueuedConnection to help prevent making the visible render lag.
 
     // set up shortcuts
@@ -491,6 +652,16 @@ AnnotationDocument *SpectacleCore::annotationDocument() const
     return m_annotationDocument.get();
 }
 
+BurstCapture *SpectacleCore::burstCapture() const
+{
+    return m_burstCapture.get();
+}
+
+PeriodicCapture *SpectacleCore::periodicCapture() const
+{
+    return m_periodicCapture.get();
+}
+
 QUrl SpectacleCore::screenCaptureUrl() const
 {
     return m_screenCaptureUrl;
@@ -636,6 +807,48 @@ void SpectacleCore::activate(const QStringList &arguments, const QString &workin
         }
     }
 
+    int burstCount = 0;
+    int burstInterval = Settings::burstInterval();
+    if (m_cliOptions[Option::Burst]) {
+        bool parseOk = false;
+        int value = parser.value(CommandLineOptions::self()->burst).toInt(&parseOk);
+        if (parseOk) {
+            burstCount = value;
+        }
+        value = parser.value(CommandLineOptions::self()->burstInterval).toInt(&parseOk);
+        if (m_cliOptions[Option::BurstInterval] && parseOk) {
+            burstInterval = value;
+        }
+    } else if (m_cliOptions[Option::BurstInterval]) {
+        Log::warning() << "--burst-interval has no effect without --burst";
+    }
+
+    int periodicInterval = 0;
+    if (m_cliOptions[Option::Periodic]) {
+        bool parseOk = false;
+        int value = parser.value(CommandLineOptions::self()->periodic).toInt(&parseOk);
+        if (parseOk) {
+            periodicInterval = value;
+        }
+    }
+    // Like the D-Bus method, fall back to the setting when the option is not given.
+    const bool skipUnchanged = m_cliOptions[Option::SkipUnchanged] || Settings::periodicSkipUnchanged();
+
+    if (m_cliOptions[Option::Compare]) {
+        auto input = parser.value(CommandLineOptions::self()->compare);
+        m_compareUrl = QUrl::fromUserInput(input, QDir::currentPath(), QUrl::AssumeLocalFile);
+        m_compareTolerance = -1;
+        if (m_cliOptions[Option::CompareTolerance]) {
+            bool parseOk = false;
+            int value = parser.value(CommandLineOptions::self()->compareTolerance).toInt(&parseOk);
+            if (parseOk) {
+                m_compareTolerance = qBound(0, value, 255);
+            }
+        }
+    } else {
+        m_compareUrl.clear();
+    }
+
     if (m_cliOptions[Option::EditExisting]) {
         auto input = parser.value(CommandLineOptions::self()->editExisting);
         m_editExistingUrl = QUrl::fromUserInput(input, QDir::currentPath(), QUrl::AssumeLocalFile);
@@ -643,12 +856,7 @@ void SpectacleCore::activate(const QStringList &arguments, const QString &workin
         auto existingLocalFile = m_editExistingUrl.toLocalFile();
         if (QFileInfo::exists(existingLocalFile)) {
             // If editing an existing image, open the annotation editor.
-            // This QImage constructor only works with local files or Qt resource file names.
-            QImage existingImage(existingLocalFile);
-            m_annotationDocument->clearAnnotations();
-            m_annotationDocument->setBaseImage(existingImage);
-            showViewerIfGuiMode();
-            SpectacleWindow::setTitleForAll(SpectacleWindow::Saved, m_editExistingUrl.fileName());
+            loadExistingImage(existingLocalFile);
             return;
         } else {
             m_cliOptions[Option::EditExisting] = false;
@@ -722,7 +930,9 @@ void SpectacleCore::activate(const QStringList &arguments, const QString &workin
         m_cliOptions[Option::WindowUnderCursor] ||
         m_cliOptions[Option::TransientOnly] ||
         m_cliOptions[Option::Region] ||
-        m_cliOptions[Option::Record];
+        m_cliOptions[Option::Record] ||
+        m_cliOptions[Option::Burst] ||
+        m_cliOptions[Option::Periodic];
     // clang-format on
 
     switch (m_startMode) {
@@ -731,6 +941,10 @@ void SpectacleCore::activate(const QStringList &arguments, const QString &workin
     case StartMode::Background:
         if (m_videoMode) {
             startRecording(recordingMode, includePointer);
+        } else if (periodicInterval > 0) {
+            startPeriodicCapture(grabMode, periodicInterval, skipUnchanged, includePointer, includeDecorations, includeShadow);
+        } else if (burstCount > 1) {
+            takeBurst(grabMode, burstCount, burstInterval, delayMsec, includePointer, includeDecorations, includeShadow);
         } else {
             takeNewScreenshot(grabMode, delayMsec, includePointer, includeDecorations, includeShadow);
         }
@@ -744,6 +958,10 @@ void SpectacleCore::activate(const QStringList &arguments, const QString &workin
             } else {
                 if (m_videoMode) {
                     startRecording(recordingMode, includePointer);
+                } else if (periodicInterval > 0) {
+                    startPeriodicCapture(grabMode, periodicInterval, skipUnchanged, includePointer, includeDecorations, includeShadow);
+                } else if (burstCount > 1) {
+                    takeBurst(grabMode, burstCount, burstInterval, delayMsec, includePointer, includeDecorations, includeShadow);
                 } else {
                     takeNewScreenshot(grabMode, delayMsec, includePointer, includeDecorations, includeShadow);
                 }
@@ -796,9 +1014,17 @@ void SpectacleCore::takeNewScreenshot(ImagePlatform::GrabMode grabMode, int time
         // the existing file with a completely unrelated image.
         m_editExistingUrl.clear();
         m_cliOptions[CommandLineOptions::EditExisting] = false;
+        // Ignore the existing image if it is still loading.
+        ++m_imageLoadSerial;
+        setImageLoading(false);
     }
 
     m_delayAnimation->stop();
+    QtCV::resetConversionCount();
+
+    if (!m_burstCapture->isActive()) {
+        m_burstCapture->clear();
+    }
 
     m_lastGrabMode = grabMode;
     m_lastIncludePointer = includePointer;
@@ -809,7 +1035,8 @@ void SpectacleCore::takeNewScreenshot(ImagePlatform::GrabMode grabMode, int time
         && m_imagePlatform->supportedShutterModes().testFlag(ImagePlatform::OnClick)
     ) {
         SpectacleWindow::setVisibilityForAll(QWindow::Hidden);
-        m_imagePlatform->doGrab(ImagePlatform::ShutterMode::OnClick, m_lastGrabMode, m_lastIncludePointer, m_lastIncludeDecorations, m_lastIncludeShadow);
+        prepareCaptureWindows();
+        doGrab(ImagePlatform::ShutterMode::OnClick);
         return;
     }
 
@@ -833,8 +1060,9 @@ void SpectacleCore::takeNewScreenshot(ImagePlatform::GrabMode grabMode, int time
 
     if (noDelay) {
         SpectacleWindow::setVisibilityForAll(QWindow::Hidden);
+        prepareCaptureWindows();
         QTimer::singleShot(timeout, this, [this]() {
-            m_imagePlatform->doGrab(ImagePlatform::ShutterMode::Immediate, m_lastGrabMode, m_lastIncludePointer, m_lastIncludeDecorations, m_lastIncludeShadow);
+            doGrab(ImagePlatform::ShutterMode::Immediate);
         });
         return;
     }
@@ -845,6 +1073,8 @@ void SpectacleCore::takeNewScreenshot(ImagePlatform::GrabMode grabMode, int time
     // skip minimize animation.
     SpectacleWindow::setVisibilityForAll(QWindow::Hidden);
     SpectacleWindow::setVisibilityForAll(QWindow::Minimized);
+    // After minimizing, which would show the new windows.
+    prepareCaptureWindows();
 }
 
 void SpectacleCore::takeNewScreenshot(int captureMode, int timeout, bool includePointer, bool includeDecorations, bool includeShadow)
@@ -853,8 +1083,265 @@ void SpectacleCore::takeNewScreenshot(int captureMode, int timeout, bool include
     takeNewScreenshot(toGrabMode(CaptureMode(captureMode), Settings::transientOnly()), timeout, includePointer, includeDecorations, includeShadow);
 }
 
+void SpectacleCore::takeBurst(ImagePlatform::GrabMode grabMode, int count, int intervalMsec, int timeout, bool includePointer, bool includeDecorations, bool includeShadow)
+{
+    if (grabMode == ImagePlatform::GrabMode::PerScreenImageNative) {
+        // Selecting a region for every frame would defeat the purpose of a burst.
+        Log::warning() << "Rectangular region is not supported in burst mode, capturing all screens instead";
+        grabMode = ImagePlatform::GrabMode::AllScreens;
+    }
+    m_burstCapture->start(count, intervalMsec);
+    takeNewScreenshot(grabMode, timeout, includePointer, includeDecorations, includeShadow);
+}
+
+void SpectacleCore::takeBurst(int captureMode, int count, int intervalMsec, int timeout, bool includePointer, bool includeDecorations, bool includeShadow)
+{
+    using CaptureMode = CaptureModeModel::CaptureMode;
+    takeBurst(toGrabMode(CaptureMode(captureMode), Settings::transientOnly()), count, intervalMsec, timeout, includePointer, includeDecorations, includeShadow);
+}
+
+void SpectacleCore::startPeriodicCapture(ImagePlatform::GrabMode grabMode, int intervalMsec, bool skipUnchanged, bool includePointer, bool includeDecorations, bool includeShadow)
+{
+    if (grabMode == ImagePlatform::GrabMode::PerScreenImageNative) {
+        Log::warning() << "Rectangular region is not supported in periodic capture mode, capturing all screens instead";
+        grabMode = ImagePlatform::GrabMode::AllScreens;
+    }
+    // Grabs are requested by PeriodicCapture, but they use the same options as any other screenshot.
+    m_lastGrabMode = grabMode;
+    m_lastIncludePointer = includePointer;
+    m_lastIncludeDecorations = includeDecorations;
+    m_lastIncludeShadow = includeShadow;
+    if (!m_periodicCapture->start(intervalMsec, skipUnchanged)) {
+        const auto message = i18nc("@info", "Periodic capture requires a local folder as the save location.");
+        if (m_startMode == StartMode::DBus) {
+            Q_EMIT dbusScreenshotFailed(message);
+        }
+        showErrorMessage(message);
+        if (m_startMode != StartMode::Gui || isGuiNull()) {
+            Q_EMIT allDone();
+        }
+    }
+}
+
+void SpectacleCore::startPeriodicCapture(int captureMode, int intervalMsec, bool skipUnchanged, bool includePointer, bool includeDecorations, bool includeShadow)
+{
+    using CaptureMode = CaptureModeModel::CaptureMode;
+    startPeriodicCapture(toGrabMode(CaptureMode(captureMode), Settings::transientOnly()), intervalMsec, skipUnchanged, includePointer, includeDecorations, includeShadow);
+}
+
+void SpectacleCore::doGrab(ImagePlatform::ShutterMode shutterMode, GrabRequester requester)
+{
+    m_pendingGrabs.append(requester);
+    m_imagePlatform->doGrab(shutterMode, m_lastGrabMode, m_lastIncludePointer, m_lastIncludeDecorations, m_lastIncludeShadow);
+}
+
+SpectacleCore::GrabRequester SpectacleCore::takeGrabRequester()
+{
+    // Image platforms answer grabs in the order they were requested.
+    // Anything we didn't ask for ourselves is treated like a normal screenshot.
+    if (m_pendingGrabs.isEmpty()) {
+        return GrabRequester::Screenshot;
+    }
+    return m_pendingGrabs.takeFirst();
+}
+
+void SpectacleCore::stopPeriodicCapture()
+{
+    m_periodicCapture->stop();
+}
+
+// Decode on a worker thread. A valid scaledSize only decodes a lower resolution version.
+static QImage readImage(const QString &fileName, const QSize &scaledSize)
+{
+    QImageReader reader(fileName);
+    if (scaledSize.isValid()) {
+        reader.setScaledSize(scaledSize);
+    } else {
+        // The user explicitly asked to open this file, so don't refuse very large images.
+        reader.setAllocationLimit(0);
+    }
+    // Convert on the worker thread instead of later on the GUI thread.
+    return QtCV::convertedTo(reader.read());
+}
+
+void SpectacleCore::loadExistingImage(const QString &localFile)
+{
+    m_annotationDocument->clearAnnotations();
+    m_annotationDocument->setBaseImage({});
+    setImageLoading(true);
+    const auto serial = ++m_imageLoadSerial;
+
+    // Only reads the header.
+    QImageReader reader(localFile);
+    const auto fullSize = reader.size();
+    // A preview is only worth it when the format can natively decode at a lower resolution,
+    // like JPEG. Otherwise, decoding a preview costs as much as decoding the full image.
+    constexpr int previewSize = 2048;
+    if (m_startMode == StartMode::Gui && reader.supportsOption(QImageIOHandler::ScaledSize)
+        && (fullSize.width() > previewSize || fullSize.height() > previewSize)) {
+        const auto scaledSize = fullSize.scaled(previewSize, previewSize, Qt::KeepAspectRatio);
+        QtConcurrent::run(readImage, localFile, scaledSize).then(this, [this, serial, fullSize](QImage preview) {
+            if (serial != m_imageLoadSerial || !m_imageLoading || preview.isNull()) {
+                return; // The full image was faster or the load was abandoned.
+            }
+            // Give the preview the same logical size as the full image,
+            // so nothing moves or resizes when it is replaced.
+            preview.setDevicePixelRatio(qreal(preview.width()) / fullSize.width());
+            m_annotationDocument->setBaseImage(preview);
+        });
+    }
+
+    QtConcurrent::run(readImage, localFile, QSize{}).then(this, [this, serial, localFile](const QImage &image) {
+        if (serial != m_imageLoadSerial) {
+            return;
+        }
+        setImageLoading(false);
+        if (image.isNull()) {
+            m_annotationDocument->setBaseImage({});
+            showErrorMessage(xi18nc("@info", "Cannot open <filename>%1</filename>.", localFile));
+            if (m_startMode == StartMode::Background) {
+                Q_EMIT allDone();
+            }
+            return;
+        }
+        m_annotationDocument->setBaseImage(image);
+        setExportImage(image);
+        // The result would be shown for the opened image.
+        ExportManager::instance()->cancelQRCodeScan();
+        if (m_startMode == StartMode::Gui && !m_videoMode && ViewerWindow::instance()) {
+            ViewerWindow::instance()->setAnnotating(true);
+        }
+        if (!m_compareUrl.isEmpty()) {
+            compareWith(m_compareUrl);
+        }
+    });
+
+    // Show the window right away instead of waiting for the image.
+    showViewerIfGuiMode();
+    SpectacleWindow::setTitleForAll(SpectacleWindow::Saved, m_editExistingUrl.fileName());
+}
+
+void SpectacleCore::speculateExport()
+{
+    // Only worth it when the image is definitely going to be saved.
+    if (m_startMode != StartMode::Gui || !Settings::autoSaveImage() || m_videoMode || m_imageLoading) {
+        return;
+    }
+    const auto revision = m_annotationDocument->revision();
+    // The image the annotation sync rendered for this revision, if there is one.
+    const bool synced = !m_annotationSyncTimer->isActive() && m_exportImageRevision == revision;
+    const auto syncedImage = synced ? ExportManager::instance()->image() : QImage();
+    if (CaptureWindow::instances().isEmpty()) {
+        // In the viewer, the image is saved as it is. Don't render it a second time.
+        if (syncedImage.isNull()) {
+            return;
+        }
+        m_speculativeExport = {revision, {}, syncedImage};
+    } else {
+        // In capture windows, the image is cropped to the selection when accepted.
+        auto rect = SelectionEditor::instance()->selection()->normalized();
+        if (rect.isEmpty()) {
+            rect = SelectionEditor::instance()->screensRect();
+        }
+        if (m_speculativeExport.revision == revision && m_speculativeExport.cropRect == rect) {
+            return;
+        }
+        QImage image;
+        if (!syncedImage.isNull()) {
+            // The synced image is the whole canvas, so the selection only needs to be copied out.
+            const auto dpr = syncedImage.devicePixelRatio();
+            image = syncedImage.copy(Geometry::rectScaled(rect, dpr).toAlignedRect() & syncedImage.rect());
+            const auto logicalXY = ImageMetaData::logicalXY(syncedImage);
+            ImageMetaData::setLogicalXY(image, logicalXY.x() + rect.x(), logicalXY.y() + rect.y());
+        } else {
+            // Nothing was annotated since the screenshot, so there is no synced image. The selection
+            // has been left alone for a while, so rendering only the selection won't get in the way.
+            image = m_annotationDocument->renderToImage(rect);
+        }
+        m_speculativeExport = {revision, rect, image};
+    }
+    ExportManager::instance()->preEncode(m_speculativeExport.image);
+}
+
+bool SpectacleCore::isImageLoading() const
+{
+    return m_imageLoading;
+}
+
+void SpectacleCore::setImageLoading(bool loading)
+{
+    if (m_imageLoading == loading) {
+        return;
+    }
+    m_imageLoading = loading;
+    Q_EMIT imageLoadingChanged();
+}
+
+void SpectacleCore::compareWith(const QUrl &url)
+{
+    startComparison(url, {});
+}
+
+void SpectacleCore::startComparison(const QUrl &url, const std::function<void()> &onFinished)
+{
+    if (!m_annotationDocument->hasBaseImage()) {
+        if (onFinished) {
+            onFinished();
+        }
+        return;
+    }
+    // The comparison needs the pixels of all screens at once.
+    const auto image = m_annotationDocument->baseImage();
+
+    ImageDiff::Options options;
+    options.tolerance = m_compareTolerance >= 0 ? m_compareTolerance : int(Settings::compareTolerance());
+    options.ignoreAntialiasing = Settings::compareIgnoreAntialiasing();
+    // The DPR doesn't matter for pixel comparisons, but the merge distance should look the same.
+    options.mergeDistance = qRound(options.mergeDistance * image.devicePixelRatio());
+    const auto serial = ++m_compareSerial;
+    // Decoding the reference and comparing large screenshots takes long enough to freeze the UI.
+    auto compare = [url, image, options]() -> std::optional<ImageDiff::Result> {
+        // This QImage constructor only works with local files or Qt resource file names.
+        const QImage reference(url.toLocalFile());
+        if (reference.isNull()) {
+            return std::nullopt;
+        }
+        return ImageDiff::compare(reference, image, options);
+    };
+    QtConcurrent::run(compare).then(this, [this, url, serial, cacheKey = image.cacheKey(), onFinished](const std::optional<ImageDiff::Result> &result) {
+        if (serial != m_compareSerial || m_annotationDocument->baseImageCacheKey() != cacheKey) {
+            return; // Replaced by another comparison or the image changed in the meantime.
+        }
+        if (!result) {
+            showErrorMessage(xi18nc("@info", "Cannot compare with <filename>%1</filename> because it could not be opened.", //
+                                    url.toDisplayString(QUrl::PreferLocalFile)));
+        } else {
+            m_annotationDocument->addComparison(result->heatmap, result->changedRects);
+            setExportImage(m_annotationDocument->renderToImage());
+
+            const qreal changedPercent = result->totalPixels > 0 ? 100.0 * result->changedPixels / result->totalPixels : 0;
+            if (auto viewer = ViewerWindow::instance()) {
+                viewer->showComparisonMessage(result->changedRects.size(), changedPercent);
+            }
+            if (m_startMode == StartMode::Background) {
+                // Meant to be read by scripts, so one region per line and no translations.
+                QTextStream out(stdout);
+                out << "changed-pixels " << result->changedPixels << ' ' << result->totalPixels << '\n';
+                for (const auto &rect : result->changedRects) {
+                    out << "changed-region " << rect.x() << ' ' << rect.y() << ' ' << rect.width() << ' ' << rect.height() << '\n';
+                }
+            }
+        }
+        if (onFinished) {
+            onFinished();
+        }
+    });
+}
+
 void SpectacleCore::cancelScreenshot()
 {
+    m_burstCapture->cancel();
+    discardPreparedCaptureWindows();
     if (m_startMode != StartMode::Gui) {
         Q_EMIT allDone();
         return;
@@ -887,7 +1374,7 @@ void SpectacleCore::showViewerIfGuiMode(bool minimized)
         return;
     }
     initViewerWindow(ViewerWindow::Image);
-    if (!m_videoMode && m_cliOptions[CommandLineOptions::EditExisting]) {
+    if (!m_videoMode && !m_imageLoading && m_cliOptions[CommandLineOptions::EditExisting]) {
         ViewerWindow::instance()->setAnnotating(true);
     }
     if (minimized) {
@@ -1091,13 +1578,16 @@ void SpectacleCore::syncExportImage()
     if (!m_annotationSyncTimer->isActive()) {
         return;
     }
+    const auto revision = m_annotationDocument->revision();
     setExportImage(m_annotationDocument->renderToImage());
+    m_exportImageRevision = revision;
 }
 
 // A convenient way to stop the sync timer and set the export image.
 void SpectacleCore::setExportImage(const QImage &image)
 {
     m_annotationSyncTimer->stop();
+    m_exportImageRevision.reset();
     ExportManager::instance()->setImage(image);
 }
 
@@ -1106,13 +1596,21 @@ QQmlEngine *SpectacleCore::getQmlEngine()
     if (m_engine == nullptr) {
         m_engine = std::make_unique<QQmlEngine>(this);
         m_engine->rootContext()->setContextObject(new KLocalizedContext(m_engine.get()));
+        // The engine takes ownership of the image provider.
+        m_engine->addImageProvider(u"burst"_s, new BurstImageProvider);
     }
     return m_engine.get();
 }
 
 void SpectacleCore::initCaptureWindows(CaptureWindow::Mode mode)
 {
-    deleteWindows();
+    if (m_captureWindowsPrepared && mode == CaptureWindow::Image) {
+        // Keep the windows made by prepareCaptureWindows().
+        m_captureWindowsPrepared = false;
+        m_viewerWindow.reset();
+    } else {
+        deleteWindows();
+    }
 
     if (mode == CaptureWindow::Video) {
         LayerShellQt::Shell::useLayerShell();
@@ -1123,16 +1621,64 @@ void SpectacleCore::initCaptureWindows(CaptureWindow::Mode mode)
     QQuickWindow::setDefaultAlphaBuffer(true);
 
     auto engine = getQmlEngine();
-    const auto screens = qApp->screens();
-    for (auto *screen : screens) {
-        const auto screenRect = Geometry::mapFromPlatformRect(screen->geometry(), screen->devicePixelRatio());
+    const auto screens = ScreenLayout::instance()->screens();
+    for (const auto &screenInfo : screens) {
+        auto screen = screenInfo.screen.data();
+        if (!screen) {
+            continue;
+        }
+        const auto &screenRect = screenInfo.logicalRect;
         // Don't show windows for screens that don't have an image.
-        if (!m_videoMode
-            && !m_annotationDocument->baseImage().isNull()
-            && !screenRect.intersects(m_annotationDocument->canvasRect())) {
+        const bool hasImage = m_videoMode
+            || !m_annotationDocument->hasBaseImage()
+            || screenRect.intersects(m_annotationDocument->canvasRect());
+        auto it = std::find_if(m_captureWindows.begin(), m_captureWindows.end(), [screen](const CaptureWindow::UniquePointer &window) {
+            return window->screenToFollow() == screen;
+        });
+        if (it != m_captureWindows.end()) {
+            if (hasImage) {
+                // Whatever is left to create is done now, while the image is already there.
+                (*it)->finishIncubation();
+            } else {
+                m_captureWindows.erase(it);
+            }
             continue;
         }
-        m_captureWindows.emplace_back(CaptureWindow::makeUnique(mode, screen, engine));
+        if (hasImage) {
+            m_captureWindows.emplace_back(CaptureWindow::makeUnique(mode, screen, engine));
+        }
+    }
+}
+
+void SpectacleCore::prepareCaptureWindows()
+{
+    // Only rectangular region captures are always followed by capture windows.
+    if (m_lastGrabMode != ImagePlatform::GrabMode::PerScreenImageNative //
+        || m_burstCapture->isActive() || !m_captureWindows.empty()) {
+        return;
+    }
+    // Windows aren't shown until the image arrives, but creating the QML takes about as long as the grab.
+    // Incubate it in the meantime instead of afterwards. Screens without an image are dropped later.
+    QQuickWindow::setDefaultAlphaBuffer(true);
+    m_viewerWasAnnotating = m_viewerWindow && m_viewerWindow->isAnnotating();
+    auto engine = getQmlEngine();
+    const auto screens = qApp->screens();
+    for (auto *screen : screens) {
+        m_captureWindows.emplace_back(CaptureWindow::makeIncubating(CaptureWindow::Image, screen, engine));
+    }
+    m_captureWindowsPrepared = true;
+}
+
+void SpectacleCore::discardPreparedCaptureWindows()
+{
+    if (!m_captureWindowsPrepared) {
+        return;
+    }
+    m_captureWindowsPrepared = false;
+    m_captureWindows.clear();
+    // Capture windows always set it, so restore it for the viewer window we go back to.
+    if (m_viewerWindow) {
+        m_viewerWindow->setAnnotating(m_viewerWasAnnotating);
     }
 }
 
@@ -1152,6 +1698,7 @@ void SpectacleCore::deleteWindows()
 {
     m_viewerWindow.reset();
     m_captureWindows.clear();
+    m_captureWindowsPrepared = false;
 }
 
 void SpectacleCore::unityLauncherUpdate(const QVariantMap &properties) const
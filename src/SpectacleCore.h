@@ -11,19 +11,23 @@
 #include <QQuickItem>
 #include <QVariantAnimation>
 
+#include "BurstCapture.h"
 #include "CaptureModeModel.h"
 #include "CommandLineOptions.h"
 #include "ExportManager.h"
 #include "Gui/Annotations/AnnotationDocument.h"
 #include "Gui/CaptureWindow.h"
 #include "Gui/ViewerWindow.h"
+#include "PeriodicCapture.h"
 #include "Platforms/PlatformLoader.h"
 #include "RecordingModeModel.h"
 #include "VideoFormatModel.h"
 #include "settings.h"
 
 #include <array>
+#include <functional>
 #include <memory>
+#include <optional>
 
 class SpectacleCore : public QObject
 {
@@ -40,6 +44,8 @@ class SpectacleCore : public QObject
     Q_PROPERTY(bool videoMode READ videoMode NOTIFY videoModeChanged)
     Q_PROPERTY(QUrl currentVideo READ currentVideo NOTIFY currentVideoChanged)
     Q_PROPERTY(AnnotationDocument *annotationDocument READ annotationDocument CONSTANT FINAL)
+    Q_PROPERTY(BurstCapture *burstCapture READ burstCapture CONSTANT FINAL)
+    Q_PROPERTY(bool imageLoading READ isImageLoading NOTIFY imageLoadingChanged FINAL)
 
 public:
     enum class StartMode {
@@ -57,6 +63,10 @@ public:
 
     AnnotationDocument *annotationDocument() const;
 
+    BurstCapture *burstCapture() const;
+
+    PeriodicCapture *periodicCapture() const;
+
     QUrl screenCaptureUrl() const;
     void setScreenCaptureUrl(const QUrl &url);
     // Used when setting the URL from CLI
@@ -78,6 +88,18 @@ public:
     QString recordedTime() const;
     Q_INVOKABLE QString timeFromMilliseconds(qint64 milliseconds) const;
 
+    /**
+     * Compare the current screenshot against the image at `url` and mark the differences as
+     * annotations: a heatmap of the changed pixels and an outline around each changed region.
+     */
+    Q_INVOKABLE void compareWith(const QUrl &url);
+
+    /**
+     * Whether an existing image is still being decoded. The base image may be a lower resolution
+     * preview in the meantime, so it must not be annotated or exported yet.
+     */
+    bool isImageLoading() const;
+
     ExportManager::Actions autoExportActions() const;
 
     void activateAction(const QString &actionName, const QVariant &parameter);
@@ -105,6 +127,29 @@ public Q_SLOTS:
                            bool includePointer = Settings::includePointer(),
                            bool includeDecorations = Settings::includeDecorations(),
                            bool includeShadow = Settings::includeShadow());
+    /**
+     * Take `count` screenshots, waiting `intervalMsec` milliseconds between each one.
+     * The timeout is only used for the first screenshot.
+     * Rectangular region mode is not supported and falls back to capturing all screens.
+     */
+    void takeBurst(int captureMode = Settings::captureMode(),
+                   int count = Settings::burstCount(),
+                   int intervalMsec = Settings::burstInterval(),
+                   int timeout = Settings::captureOnClick() ? -1 : Settings::captureDelay() * 1000,
+                   bool includePointer = Settings::includePointer(),
+                   bool includeDecorations = Settings::includeDecorations(),
+                   bool includeShadow = Settings::includeShadow());
+    /**
+     * Take a screenshot every `intervalMsec` milliseconds and save it until stopPeriodicCapture() is called.
+     * Rectangular region mode is not supported and falls back to capturing all screens.
+     */
+    void startPeriodicCapture(int captureMode = Settings::captureMode(),
+                              int intervalMsec = Settings::periodicInterval(),
+                              bool skipUnchanged = Settings::periodicSkipUnchanged(),
+                              bool includePointer = Settings::includePointer(),
+                              bool includeDecorations = Settings::includeDecorations(),
+                              bool includeShadow = Settings::includeShadow());
+    void stopPeriodicCapture();
     void cancelScreenshot();
     void showErrorMessage(const QString &message);
 
@@ -119,6 +164,7 @@ Q_SIGNALS:
     void videoModeChanged(bool videoMode);
     void currentVideoChanged(const QUrl &currentVideo);
     void recordedTimeChanged();
+    void imageLoadingChanged();
 
 private:
     explicit SpectacleCore(QObject *parent = nullptr);
@@ -128,8 +174,24 @@ private:
         Recording,
     };
 
+    // Who asked the image platform for the next screenshot.
+    enum class GrabRequester {
+        Screenshot,
+        PeriodicCapture,
+    };
+
+    void doGrab(ImagePlatform::ShutterMode shutterMode, GrabRequester requester = GrabRequester::Screenshot);
+    GrabRequester takeGrabRequester();
     void takeNewScreenshot(ImagePlatform::GrabMode grabMode, int timeout, bool includePointer, bool includeDecorations, bool includeShadow);
+    void takeBurst(ImagePlatform::GrabMode grabMode, int count, int intervalMsec, int timeout, bool includePointer, bool includeDecorations, bool includeShadow);
+    void startPeriodicCapture(ImagePlatform::GrabMode grabMode, int intervalMsec, bool skipUnchanged, bool includePointer, bool includeDecorations, bool includeShadow);
     void setExportImage(const QImage &image);
+    // Compare the base image with the image at `url` on a worker thread and add the differences
+    // as annotations. `onFinished` is called afterwards unless the comparison became outdated.
+    void startComparison(const QUrl &url, const std::function<void()> &onFinished);
+    void loadExistingImage(const QString &localFile);
+    void speculateExport();
+    void setImageLoading(bool loading);
     void showViewerIfGuiMode(bool minimized = false);
     void doNotify(ScreenCapture type, const ExportManager::Actions &actions, const QUrl &saveUrl);
     ImagePlatform::GrabMode toGrabMode(CaptureModeModel::CaptureMode captureMode, bool transientOnly) const;
@@ -137,6 +199,8 @@ private:
     bool isGuiNull() const;
     QQmlEngine *getQmlEngine();
     void initCaptureWindows(CaptureWindow::Mode mode);
+    void prepareCaptureWindows();
+    void discardPreparedCaptureWindows();
     void initViewerWindow(ViewerWindow::Mode mode);
     void deleteWindows();
     void unityLauncherUpdate(const QVariantMap &properties) const;
@@ -146,12 +210,27 @@ private:
 
     static SpectacleCore *s_self;
     std::unique_ptr<AnnotationDocument> m_annotationDocument = nullptr;
+    std::unique_ptr<BurstCapture> m_burstCapture;
+    std::unique_ptr<PeriodicCapture> m_periodicCapture;
     StartMode m_startMode = StartMode::Gui;
     QUrl m_screenCaptureUrl;
     std::unique_ptr<ImagePlatform> m_imagePlatform;
     std::unique_ptr<VideoPlatform> m_videoPlatform;
     std::unique_ptr<QQmlEngine> m_engine;
     std::unique_ptr<QTimer> m_annotationSyncTimer;
+    std::unique_ptr<QTimer> m_speculativeExportTimer;
+    std::unique_ptr<QTimer> m_clipboardOwnerTimer;
+    // An image that was rendered and encoded ahead of time because it is going to be saved.
+    struct SpeculativeExport {
+        quint64 revision = 0;
+        // Empty when the whole canvas was rendered.
+        QRectF cropRect;
+        QImage image;
+        // Set while the image is being used, so that the changes it causes don't discard it.
+        bool accepted = false;
+    } m_speculativeExport;
+    // The document revision of the export image when the annotation sync rendered it.
+    std::optional<quint64> m_exportImageRevision;
     std::unique_ptr<QVariantAnimation> m_delayAnimation;
     std::unique_ptr<QEventLoopLocker> m_eventLoopLocker;
 
@@ -163,16 +242,28 @@ private:
     // For some reason, removeIf/erase_if/find_if then erase doesn't work with QList/QList,
     // so we have to use std::vector. Something about use of a deleted unique_ptr function.
     std::vector<CaptureWindow::UniquePointer> m_captureWindows;
+    // Whether m_captureWindows are hidden and incubating while a rectangular region is being captured.
+    bool m_captureWindowsPrepared = false;
+    bool m_viewerWasAnnotating = false;
 
     std::array<bool, CommandLineOptions::TotalOptions> m_cliOptions = {};
 
     QUrl m_editExistingUrl;
     QUrl m_outputUrl;
+    QUrl m_compareUrl;
+    int m_compareTolerance = -1; // -1 means use the setting
+    // Incremented for every comparison so that results of older ones can be ignored.
+    quint64 m_compareSerial = 0;
+    bool m_imageLoading = false;
+    // Incremented for every load so that results of older loads can be ignored.
+    quint64 m_imageLoadSerial = 0;
 
     ImagePlatform::GrabMode m_lastGrabMode = ImagePlatform::GrabMode::NoGrabModes;
     bool m_lastIncludePointer = false; // cli default value
     bool m_lastIncludeDecorations = true; // cli default value
     bool m_lastIncludeShadow = true; // cli default value
+    // One entry per grab that hasn't been answered yet, oldest first.
+    QList<GrabRequester> m_pendingGrabs;
     VideoPlatform::RecordingMode m_lastRecordingMode = VideoPlatform::NoRecordingModes;
     bool m_videoMode = false;
     QUrl m_currentVideo;
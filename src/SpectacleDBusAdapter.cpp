@@ -5,8 +5,11 @@
 
 #include "SpectacleDBusAdapter.h"
 #include "Platforms/ImagePlatform.h"
+#include "ScreenshotIndex.h"
 #include "settings.h"
 
+#include <QDir>
+
 SpectacleDBusAdapter::SpectacleDBusAdapter(SpectacleCore *parent)
     : QDBusAbstractAdaptor(parent)
 {
@@ -54,6 +57,60 @@ void SpectacleDBusAdapter::RectangularRegion(int includeMousePointer)
                                 false);
 }
 
+void SpectacleDBusAdapter::Burst(int captureMode, int count, int intervalMsec, int includeMousePointer)
+{
+    parent()->takeBurst(captureMode == -1 ? Settings::captureMode() : captureMode,
+                        count,
+                        intervalMsec == -1 ? Settings::burstInterval() : intervalMsec,
+                        0,
+                        (includeMousePointer == -1) ? Settings::includePointer() : includeMousePointer,
+                        Settings::includeDecorations(),
+                        Settings::includeShadow());
+}
+
+void SpectacleDBusAdapter::StartPeriodicCapture(int captureMode, int intervalMsec, int skipUnchanged, int includeMousePointer)
+{
+    parent()->startPeriodicCapture(captureMode == -1 ? Settings::captureMode() : captureMode,
+                                   intervalMsec == -1 ? Settings::periodicInterval() : intervalMsec,
+                                   skipUnchanged == -1 ? Settings::periodicSkipUnchanged() : skipUnchanged,
+                                   (includeMousePointer == -1) ? Settings::includePointer() : includeMousePointer,
+                                   Settings::includeDecorations(),
+                                   Settings::includeShadow());
+}
+
+void SpectacleDBusAdapter::StopPeriodicCapture()
+{
+    parent()->stopPeriodicCapture();
+}
+
+QVariantMap SpectacleDBusAdapter::PeriodicCaptureStatus()
+{
+    return parent()->periodicCapture()->status();
+}
+
+QStringList SpectacleDBusAdapter::FindSimilarScreenshots(const QString &fileName, int maxDistance)
+{
+    const auto url = QUrl::fromUserInput(fileName, QDir::currentPath(), QUrl::AssumeLocalFile);
+    const auto matches = ScreenshotIndex::instance()->findSimilar(url, maxDistance == -1 ? ScreenshotIndex::defaultMaxDistance : maxDistance);
+    QStringList result;
+    result.reserve(matches.size());
+    for (const auto &match : matches) {
+        result.append(match.entry.url.toString(QUrl::PreferLocalFile));
+    }
+    return result;
+}
+
+QStringList SpectacleDBusAdapter::FindScreenshotsOfWindow(const QString &windowTitle)
+{
+    const auto entries = ScreenshotIndex::instance()->findByWindowTitle(windowTitle);
+    QStringList result;
+    result.reserve(entries.size());
+    for (const auto &entry : entries) {
+        result.append(entry.url.toString(QUrl::PreferLocalFile));
+    }
+    return result;
+}
+
 void SpectacleDBusAdapter::RecordRegion(int includeMousePointer)
 {
     parent()->startRecording(VideoPlatform::Region, includeMousePointer == -1 ? Settings::videoIncludePointer() : includeMousePointer);
@@ -25,6 +25,12 @@ public Q_SLOTS:
     Q_NOREPLY void ActiveWindow(int includeWindowDecorations, int includeMousePointer, int includeWindowShadow);
     Q_NOREPLY void WindowUnderCursor(int includeWindowDecorations, int includeMousePointer, int includeWindowShadow);
     Q_NOREPLY void RectangularRegion(int includeMousePointer);
+    Q_NOREPLY void Burst(int captureMode, int count, int intervalMsec, int includeMousePointer);
+    Q_NOREPLY void StartPeriodicCapture(int captureMode, int intervalMsec, int skipUnchanged, int includeMousePointer);
+    Q_NOREPLY void StopPeriodicCapture();
+    QVariantMap PeriodicCaptureStatus();
+    QStringList FindSimilarScreenshots(const QString &fileName, int maxDistance);
+    QStringList FindScreenshotsOfWindow(const QString &windowTitle);
     Q_NOREPLY void RecordRegion(int includeMousePointer);
     Q_NOREPLY void RecordScreen(int includeMousePointer);
     Q_NOREPLY void RecordWindow(int includeMousePointer);
@@ -34,6 +40,7 @@ Q_SIGNALS:
 
     void ScreenshotTaken(const QString &fileName);
     void ScreenshotFailed(const QString &message);
+    void PeriodicCaptureSaved(const QString &fileName, int captureCost, int encodeCost, int backlog);
     void RecordingTaken(const QString &fileName);
     void RecordingFailed(const QString &message);
 };
@@ -0,0 +1,145 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "ThumbnailCache.h"
+#include "DebugUtils.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QMimeDatabase>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <array>
+
+using namespace Qt::StringLiterals;
+
+struct SizeCategory {
+    QString name;
+    int size;
+};
+
+// Largest first so that each thumbnail can be scaled from the previous one.
+static const std::array<SizeCategory, 2> sizeCategories = {{{u"large"_s, 256}, {u"normal"_s, 128}}};
+
+static constexpr auto privatePermissions = QFile::ReadOwner | QFile::WriteOwner;
+
+// The spec requires the canonical URI of the file, with special characters percent encoded.
+static QString fileUri(const QString &filePath)
+{
+    return QUrl::fromLocalFile(filePath).toString(QUrl::FullyEncoded);
+}
+
+QString ThumbnailCache::directory(const QString &sizeName)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + u"/thumbnails/"_s + sizeName;
+}
+
+QString ThumbnailCache::thumbnailPath(const QString &filePath, const QString &sizeName)
+{
+    const auto hash = QCryptographicHash::hash(fileUri(filePath).toUtf8(), QCryptographicHash::Md5).toHex();
+    return directory(sizeName) + u'/' + QString::fromLatin1(hash) + u".png"_s;
+}
+
+static bool makeDirectory(const QString &path)
+{
+    if (QFileInfo::exists(path)) {
+        return true;
+    }
+    QDir dir;
+    // The thumbnail directories must only be accessible by the user.
+    return dir.mkpath(QFileInfo(path).path()) && dir.mkdir(path, privatePermissions | QFile::ExeOwner);
+}
+
+bool ThumbnailCache::write(const QImage &image, const FileInfo &info)
+{
+    if (image.isNull() || info.filePath.isEmpty()) {
+        return false;
+    }
+    const auto uri = fileUri(info.filePath);
+    const auto mtime = QString::number(info.lastModified.toSecsSinceEpoch());
+    const auto size = QString::number(info.size);
+    const auto software = QCoreApplication::applicationName() + u' ' + QCoreApplication::applicationVersion();
+
+    bool success = true;
+    QImage source = image;
+    for (const auto &category : sizeCategories) {
+        const auto dirPath = directory(category.name);
+        if (!makeDirectory(dirPath)) {
+            Log::warning() << "Cannot create thumbnail directory" << dirPath;
+            return false;
+        }
+        // Thumbnails are never larger than the original.
+        QImage thumbnail = source.width() > category.size || source.height() > category.size
+            ? source.scaled(category.size, category.size, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+            : source;
+        thumbnail.setDevicePixelRatio(1);
+        thumbnail.setText(u"Thumb::URI"_s, uri);
+        thumbnail.setText(u"Thumb::MTime"_s, mtime);
+        thumbnail.setText(u"Thumb::Size"_s, size);
+        thumbnail.setText(u"Thumb::Mimetype"_s, info.mimeType);
+        // The size of the image as it is written, not of the screenshot it was made from.
+        thumbnail.setText(u"Thumb::Image::Width"_s, QString::number(thumbnail.width()));
+        thumbnail.setText(u"Thumb::Image::Height"_s, QString::number(thumbnail.height()));
+        thumbnail.setText(u"Software"_s, software);
+
+        // Readers must never see a partially written thumbnail.
+        const auto path = thumbnailPath(info.filePath, category.name);
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            Log::warning() << "Cannot write thumbnail" << path << file.errorString();
+            success = false;
+            continue;
+        }
+        // Set on the temporary file so the thumbnail is never readable by others, not even briefly.
+        if (!file.setPermissions(privatePermissions)) {
+            file.cancelWriting();
+            Log::warning() << "Cannot set the permissions of thumbnail" << path << file.errorString();
+            success = false;
+            continue;
+        }
+        QImageWriter writer(&file, "png"_ba);
+        if (!writer.write(thumbnail)) {
+            file.cancelWriting();
+            Log::warning() << "Cannot write thumbnail" << path << writer.errorString();
+            success = false;
+            continue;
+        }
+        if (!file.commit()) {
+            success = false;
+            continue;
+        }
+        source = thumbnail;
+    }
+    return success;
+}
+
+void ThumbnailCache::writeInBackground(const QImage &image, const QString &filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    if (image.isNull() || !fileInfo.exists()) {
+        return;
+    }
+    const auto canonicalPath = fileInfo.canonicalFilePath();
+    // Don't write thumbnails of thumbnails.
+    if (canonicalPath.startsWith(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + u"/thumbnails/"_s)) {
+        return;
+    }
+    // Stat the file now. It may be replaced or touched by the time the thumbnails are written,
+    // in which case readers should ignore them.
+    FileInfo info{
+        canonicalPath,
+        fileInfo.lastModified(),
+        fileInfo.size(),
+        QMimeDatabase().mimeTypeForFile(fileInfo, QMimeDatabase::MatchExtension).name(),
+    };
+    // Nothing waits for the result.
+    QtConcurrent::run(&ThumbnailCache::write, image, info);
+}
@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QImage>
+#include <QString>
+
+/**
+ * Writes thumbnails for saved screenshots into the shared thumbnail cache described by the
+ * freedesktop.org thumbnail managing standard.
+ *
+ * File managers, image viewers and notifications only use a cached thumbnail when its URI and
+ * modification time match the file, so it has to be written after the file is closed.
+ * We already have the pixels, so this saves every one of them from decoding the whole file again.
+ */
+namespace ThumbnailCache
+{
+struct FileInfo {
+    // Absolute path of the saved file.
+    QString filePath;
+    QDateTime lastModified;
+    qint64 size = 0;
+    QString mimeType;
+};
+
+/**
+ * Directory of thumbnails with the given size category ("normal" or "large").
+ */
+QString directory(const QString &sizeName);
+
+/**
+ * Path of the thumbnail of the file with the given size category.
+ */
+QString thumbnailPath(const QString &filePath, const QString &sizeName);
+
+/**
+ * Write the normal (128px) and large (256px) thumbnails of an image saved to `info.filePath`.
+ * Thread safe. Returns false if any of the thumbnails couldn't be written.
+ */
+bool write(const QImage &image, const FileInfo &info);
+
+/**
+ * Gather the file info of a saved local file and write its thumbnails on a worker thread.
+ */
+void writeInBackground(const QImage &image, const QString &filePath);
+}
@@ -0,0 +1,147 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QRandomGenerator>
+#include <QTest>
+#include <QThreadPool>
+
+#include "Gui/Annotations/AnnotationDocument.h"
+#include "QtCV.h"
+
+class AnnotationDocumentTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Red on the left half, blue on the right half.
+    static QImage twoColorImage();
+
+private Q_SLOTS:
+    void testUndoCrop_data();
+    void testUndoCrop();
+    void testUndoComparison();
+    void testBandedPainting();
+};
+
+QImage AnnotationDocumentTest::twoColorImage()
+{
+    QImage image(4, 4, QtCV::workingFormat);
+    image.fill(Qt::red);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = image.width() / 2; x < image.width(); ++x) {
+            image.setPixelColor(x, y, Qt::blue);
+        }
+    }
+    return image;
+}
+
+void AnnotationDocumentTest::testUndoCrop_data()
+{
+    QTest::addColumn<bool>("gui");
+    QTest::newRow("gui") << true;
+    QTest::newRow("background") << false;
+}
+
+// SpectacleCore only releases the uncropped base image when there is no editor to undo the crop with.
+void AnnotationDocumentTest::testUndoCrop()
+{
+    QFETCH(bool, gui);
+    const auto image = twoColorImage();
+    AnnotationDocument document;
+    document.setBaseImage(image);
+
+    const QRectF cropRect{2, 0, 2, 4};
+    document.cropCanvas(cropRect);
+    QCOMPARE(document.canvasRect(), cropRect);
+    const auto cropped = document.renderToImage();
+    QCOMPARE(cropped.size(), QSize(2, 4));
+    QCOMPARE(cropped.pixelColor(0, 0), QColor(Qt::blue));
+
+    if (!gui) {
+        document.releaseUncroppedBaseImage();
+        // Releasing memory must not change what the cropped document looks like.
+        QCOMPARE(document.renderToImage().convertToFormat(QtCV::workingFormat), cropped.convertToFormat(QtCV::workingFormat));
+    }
+
+    document.undo();
+    QCOMPARE(document.canvasRect(), QRectF(0, 0, 4, 4));
+    const auto restored = document.renderToImage().convertToFormat(QtCV::workingFormat);
+    QCOMPARE(restored.size(), image.size());
+    QCOMPARE(restored.pixelColor(3, 0), QColor(Qt::blue));
+    if (gui) {
+        // The editor needs everything back.
+        QCOMPARE(restored, image);
+    } else {
+        // Only the cropped pixels are left, which is why this must not happen with an editor.
+        QCOMPARE(restored.pixelColor(0, 0).alpha(), 0);
+    }
+}
+
+void AnnotationDocumentTest::testUndoComparison()
+{
+    const auto image = twoColorImage();
+    AnnotationDocument document;
+    document.setBaseImage(image);
+
+    QImage heatmap(image.size(), QtCV::workingFormat);
+    heatmap.fill(Qt::transparent);
+    heatmap.setPixelColor(0, 0, Qt::yellow);
+    heatmap.setPixelColor(3, 3, Qt::yellow);
+    document.addComparison(heatmap, {QRect{0, 0, 1, 1}, QRect{3, 3, 1, 1}});
+    QCOMPARE(document.undoStackDepth(), 1);
+    QVERIFY(document.renderToImage().convertToFormat(QtCV::workingFormat) != image);
+
+    document.undo();
+    QCOMPARE(document.undoStackDepth(), 0);
+    QCOMPARE(document.renderToImage().convertToFormat(QtCV::workingFormat), image);
+}
+
+// Painting a large region in bands on several threads must give the same pixels
+// as painting it in small pieces on one thread.
+void AnnotationDocumentTest::testBandedPainting()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(4);
+    QRandomGenerator random(7);
+    QImage image(2048, 1024, QtCV::workingFormat);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixelColor(x, y, QColor(x % 256, y % 256, (x + y) % 256));
+        }
+    }
+    AnnotationDocument document;
+    document.setBaseImage(image);
+
+    // Translucent, so painting anything twice where bands or pieces meet would show.
+    QImage heatmap(image.size(), QtCV::workingFormat);
+    heatmap.fill(Qt::transparent);
+    QList<QRect> rects;
+    for (int i = 0; i < 40; ++i) {
+        const QRect rect(random.bounded(image.width() - 300), random.bounded(image.height() - 300), //
+                         random.bounded(1, 300), random.bounded(1, 300));
+        rects.append(rect);
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            for (int x = rect.left(); x <= rect.right(); ++x) {
+                heatmap.setPixelColor(x, y, QColor(255, random.bounded(256), 0, 128));
+            }
+        }
+    }
+    document.addComparison(heatmap, rects);
+
+    const QRectF canvasRect{QPointF{0, 0}, image.size()};
+    const auto banded = document.renderToImage(canvasRect).convertToFormat(QtCV::workingFormat);
+    QCOMPARE(banded.size(), image.size());
+    // Not a divisor of the band height, so pieces and bands end at different rows.
+    constexpr int pieceSize = 200;
+    for (int y = 0; y < image.height(); y += pieceSize) {
+        for (int x = 0; x < image.width(); x += pieceSize) {
+            const auto pieceRect = QRect(x, y, pieceSize, pieceSize) & image.rect();
+            const auto piece = document.renderToImage(pieceRect).convertToFormat(QtCV::workingFormat);
+            QCOMPARE(piece, banded.copy(pieceRect));
+        }
+    }
+}
+
+QTEST_MAIN(AnnotationDocumentTest)
+
+#include "AnnotationDocumentTest.moc"
@@ -0,0 +1,165 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QRandomGenerator>
+#include <QRegion>
+#include <QTest>
+
+#include "Gui/Annotations/DamageTracker.h"
+
+class DamageTrackerTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Check that the rects are disjoint, within the limit and cover everything that was added.
+    static void verifyInvariants(const DamageTracker &damage, const QList<QRect> &added);
+
+private Q_SLOTS:
+    void testEmpty();
+    void testContained();
+    void testMerge_data();
+    void testMerge();
+    void testMergeChain();
+    void testMaxRectCount();
+    void testResetAndClear();
+    void testRandom();
+};
+
+void DamageTrackerTest::verifyInvariants(const DamageTracker &damage, const QList<QRect> &added)
+{
+    const auto &rects = damage.rects();
+    QVERIFY(rects.size() <= DamageTracker::maxRectCount);
+    for (qsizetype i = 0; i < rects.size(); ++i) {
+        QVERIFY(!rects[i].isEmpty());
+        for (qsizetype j = i + 1; j < rects.size(); ++j) {
+            QVERIFY2(!rects[i].intersects(rects[j]), "Rects must not be repainted twice");
+        }
+    }
+    QRegion covered;
+    for (const auto &rect : rects) {
+        covered += rect;
+    }
+    for (const auto &rect : added) {
+        QVERIFY(covered.contains(rect));
+        QCOMPARE(covered.intersected(rect), QRegion(rect));
+    }
+}
+
+void DamageTrackerTest::testEmpty()
+{
+    DamageTracker damage;
+    QVERIFY(damage.isEmpty());
+    damage.add({});
+    damage.add({10, 10, 0, 5});
+    QVERIFY(damage.isEmpty());
+    QCOMPARE(damage.area(), qint64(0));
+    QCOMPARE(damage.boundingRect(), QRect());
+}
+
+void DamageTrackerTest::testContained()
+{
+    DamageTracker damage;
+    damage.add({0, 0, 100, 100});
+    damage.add({10, 10, 20, 20});
+    QCOMPARE(damage.rects(), QList<QRect>{QRect(0, 0, 100, 100)});
+}
+
+void DamageTrackerTest::testMerge_data()
+{
+    QTest::addColumn<QRect>("first");
+    QTest::addColumn<QRect>("second");
+    QTest::addColumn<QList<QRect>>("expected");
+
+    QTest::newRow("intersecting") << QRect(0, 0, 100, 100) << QRect(50, 50, 100, 100) //
+                                  << QList<QRect>{QRect(0, 0, 150, 150)};
+    // Cheaper to repaint the small gap than to go through the annotations twice.
+    QTest::newRow("adjacent") << QRect(0, 0, 100, 100) << QRect(100, 0, 100, 100) //
+                              << QList<QRect>{QRect(0, 0, 200, 100)};
+    QTest::newRow("close") << QRect(0, 0, 100, 100) << QRect(110, 0, 100, 100) //
+                           << QList<QRect>{QRect(0, 0, 210, 100)};
+    // Opposite corners, like a stroke and a hover outline.
+    QTest::newRow("far apart") << QRect(0, 0, 100, 100) << QRect(2000, 1000, 100, 100) //
+                               << QList<QRect>{QRect(0, 0, 100, 100), QRect(2000, 1000, 100, 100)};
+}
+
+void DamageTrackerTest::testMerge()
+{
+    QFETCH(QRect, first);
+    QFETCH(QRect, second);
+    QFETCH(QList<QRect>, expected);
+
+    DamageTracker damage;
+    damage.add(first);
+    damage.add(second);
+    QCOMPARE(damage.rects(), expected);
+    verifyInvariants(damage, {first, second});
+
+    const auto stats = damage.stats();
+    QCOMPARE(stats.rectCount, expected.size());
+    QCOMPARE(stats.area, damage.area());
+    QCOMPARE(stats.boundingArea, qint64(damage.boundingRect().width()) * damage.boundingRect().height());
+    QVERIFY(stats.area <= stats.boundingArea);
+}
+
+// A merge can make the result intersect a rect that was already checked.
+void DamageTrackerTest::testMergeChain()
+{
+    DamageTracker damage;
+    const QList<QRect> added{{0, 0, 100, 100}, {1000, 0, 100, 100}, {500, 0, 100, 100}, {90, 50, 1000, 10}};
+    for (const auto &rect : added) {
+        damage.add(rect);
+    }
+    QCOMPARE(damage.rects().size(), qsizetype(1));
+    QCOMPARE(damage.boundingRect(), QRect(0, 0, 1100, 100));
+    verifyInvariants(damage, added);
+}
+
+void DamageTrackerTest::testMaxRectCount()
+{
+    DamageTracker damage;
+    QList<QRect> added;
+    // A grid of small rects far enough apart to never be worth merging on their own.
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 5; ++x) {
+            added.append({x * 1000, y * 1000, 10, 10});
+            damage.add(added.last());
+        }
+    }
+    QCOMPARE(damage.rects().size(), DamageTracker::maxRectCount);
+    verifyInvariants(damage, added);
+    // Merging only adds what is needed instead of falling back to the bounding rect.
+    QVERIFY(damage.area() < qint64(damage.boundingRect().width()) * damage.boundingRect().height());
+}
+
+void DamageTrackerTest::testResetAndClear()
+{
+    DamageTracker damage;
+    damage.add({0, 0, 10, 10});
+    damage.add({5000, 5000, 10, 10});
+    damage.reset({100, 100, 50, 50});
+    QCOMPARE(damage.rects(), QList<QRect>{QRect(100, 100, 50, 50)});
+    damage.clear();
+    QVERIFY(damage.isEmpty());
+    QCOMPARE(damage.stats().rectCount, qsizetype(0));
+    QCOMPARE(damage.stats().area, qint64(0));
+}
+
+void DamageTrackerTest::testRandom()
+{
+    QRandomGenerator random(1234);
+    for (int run = 0; run < 20; ++run) {
+        DamageTracker damage;
+        QList<QRect> added;
+        for (int i = 0; i < 50; ++i) {
+            added.append({random.bounded(4000), random.bounded(3000), random.bounded(1, 300), random.bounded(1, 300)});
+            damage.add(added.last());
+            verifyInvariants(damage, added);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(DamageTrackerTest)
+
+#include "DamageTrackerTest.moc"
@@ -0,0 +1,95 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "Gui/Annotations/History.h"
+
+class HistoryTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static HistoryItem::shared_ptr rectangleItem(const QRectF &rect, const QColor &color);
+
+private Q_SLOTS:
+    void testJournalRoundTrip();
+};
+
+HistoryItem::shared_ptr HistoryTest::rectangleItem(const QRectF &rect, const QColor &color)
+{
+    auto item = std::make_shared<HistoryItem>();
+    QPainterPath path;
+    path.addRect(rect);
+    std::get<Traits::Geometry::Opt>(item->traits()).emplace(path);
+    std::get<Traits::Interactive::Opt>(item->traits()).emplace();
+    std::get<Traits::Visual::Opt>(item->traits()).emplace();
+    auto pen = Traits::Stroke::defaultPen();
+    pen.setBrush(color);
+    std::get<Traits::Stroke::Opt>(item->traits()).emplace(pen);
+    std::get<Traits::Fill::Opt>(item->traits()).emplace(QBrush(color));
+    Traits::initOptTuple(item->traits());
+    return item;
+}
+
+// Deleted items far enough from the current state are moved to the journal when memory is tight.
+// Undoing the deletion must bring back exactly the same traits.
+void HistoryTest::testJournalRoundTrip()
+{
+    QTemporaryDir journalDirectory;
+    QVERIFY(journalDirectory.isValid());
+    History history;
+
+    const auto deleted = rectangleItem({10, 10, 50, 30}, Qt::red);
+    const auto expectedTraits = deleted->traits();
+    const auto expectedRect = deleted->renderRect();
+    history.push(deleted);
+    auto deletion = std::make_shared<HistoryItem>();
+    HistoryItem::setItemRelations(deleted, deletion);
+    std::get<Traits::Meta::Delete::Opt>(deletion->traits()).emplace();
+    history.push(deletion);
+    // More than enough items to keep in memory after the deletion.
+    constexpr int laterCount = 32;
+    for (int i = 0; i < laterCount; ++i) {
+        history.push(rectangleItem({qreal(i), qreal(i), 10, 10}, Qt::blue));
+    }
+
+    history.trimMemory(0, [&journalDirectory] {
+        return journalDirectory.path();
+    });
+    QVERIFY(!std::get<Traits::Geometry::Opt>(deleted->traits()).has_value());
+    // The deletion itself is a tiny meta item that stays in memory.
+    QVERIFY(std::get<Traits::Meta::Delete::Opt>(deletion->traits()).has_value());
+    // Items that can still be seen are never moved.
+    QCOMPARE(history.currentItem()->traits(), rectangleItem({laterCount - 1, laterCount - 1, 10, 10}, Qt::blue)->traits());
+
+    for (int i = 0; i < laterCount; ++i) {
+        QVERIFY(history.undo());
+    }
+    QCOMPARE(history.currentItem(), deletion);
+    QVERIFY(history.undo());
+    QCOMPARE(history.currentItem(), deleted);
+    QVERIFY(history.itemVisible(deleted));
+    QCOMPARE(deleted->traits(), expectedTraits);
+    QCOMPARE(deleted->renderRect(), expectedRect);
+
+    // Redo everything and do it all again. The restored item can be moved again.
+    for (int i = 0; i < laterCount + 1; ++i) {
+        QVERIFY(history.redo());
+    }
+    QVERIFY(!history.itemVisible(deleted));
+    history.trimMemory(0, [&journalDirectory] {
+        return journalDirectory.path();
+    });
+    QVERIFY(!std::get<Traits::Geometry::Opt>(deleted->traits()).has_value());
+    for (int i = 0; i < laterCount + 1; ++i) {
+        QVERIFY(history.undo());
+    }
+    QCOMPARE(deleted->traits(), expectedTraits);
+}
+
+QTEST_MAIN(HistoryTest)
+
+#include "HistoryTest.moc"
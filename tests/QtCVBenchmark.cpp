@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QTest>
+
+#include "QtCV.h"
+
+// Compares one thread with all of the threads of the shared pool for the paths that use it.
+class QtCVBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    cv::Mat mImage;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+    void benchmarkBlur_data();
+    void benchmarkBlur();
+    void benchmarkResize_data();
+    void benchmarkResize();
+    void testBlurMatchesSerial();
+};
+
+void QtCVBenchmark::initTestCase()
+{
+    QtCV::initializeThreading();
+    // The size of a 4K screenshot.
+    mImage.create(2160, 3840, CV_8UC4);
+    cv::randu(mImage, cv::Scalar::all(0), cv::Scalar::all(256));
+}
+
+void QtCVBenchmark::cleanup()
+{
+    // Back to the default number of threads.
+    cv::setNumThreads(-1);
+}
+
+void QtCVBenchmark::benchmarkBlur_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addRow("single thread") << 1;
+    QTest::addRow("shared pool") << -1;
+}
+
+void QtCVBenchmark::benchmarkBlur()
+{
+    QFETCH(int, threads);
+    cv::setNumThreads(threads);
+    cv::Mat result;
+    QBENCHMARK {
+        QtCV::parallelStackOrGaussianBlur(mImage, result, 16);
+    }
+}
+
+void QtCVBenchmark::benchmarkResize_data()
+{
+    benchmarkBlur_data();
+}
+
+void QtCVBenchmark::benchmarkResize()
+{
+    QFETCH(int, threads);
+    cv::setNumThreads(threads);
+    cv::Mat result;
+    QBENCHMARK {
+        cv::resize(mImage, result, {mImage.cols * 2 / 3, mImage.rows * 2 / 3}, 0, 0, cv::INTER_AREA);
+    }
+}
+
+void QtCVBenchmark::testBlurMatchesSerial()
+{
+    cv::Mat serial;
+    QtCV::stackOrGaussianBlurCompatibility(mImage, serial, {}, 16, 16);
+    cv::Mat tiled = mImage.clone();
+    QtCV::parallelStackOrGaussianBlur(tiled, tiled, 16);
+    QCOMPARE(cv::norm(serial, tiled, cv::NORM_INF), 0.0);
+}
+
+QTEST_GUILESS_MAIN(QtCVBenchmark)
+
+#include "QtCVBenchmark.moc"
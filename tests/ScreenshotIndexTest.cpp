@@ -0,0 +1,202 @@
+/* SPDX-FileCopyrightText: 2024 Noah Davis <noahadvs@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QFile>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "ScreenshotIndex.h"
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+class ScreenshotIndexTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    // A 9x8 image that has exactly the given difference hash.
+    static QImage imageWithHash(quint64 hash);
+    // Add an entry and wait until it can be found.
+    static void addAndWait(quint64 hash, const QUrl &url, const QDateTime &timestamp);
+
+    QDateTime m_timestamp = QDateTime::fromString(u"2024-03-22T20:43:25Z"_s, Qt::ISODate);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void testDistance_data();
+    void testDistance();
+    void testDifferenceHash();
+    void testFindSimilar();
+    void testReplaceUrl();
+    void testMatchesBruteForce();
+};
+
+QImage ScreenshotIndexTest::imageWithHash(quint64 hash)
+{
+    QImage image(9, 8, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        auto row = image.scanLine(y);
+        row[0] = 128;
+        for (int x = 0; x < 8; ++x) {
+            const bool bit = (hash >> (63 - (y * 8 + x))) & 1;
+            row[x + 1] = bit ? row[x] + 10 : row[x] - 10;
+        }
+    }
+    return image;
+}
+
+void ScreenshotIndexTest::addAndWait(quint64 hash, const QUrl &url, const QDateTime &timestamp)
+{
+    auto index = ScreenshotIndex::instance();
+    index->add(imageWithHash(hash), url, timestamp);
+    QTRY_VERIFY(std::ranges::any_of(index->findSimilar(hash, 0), [&](const ScreenshotIndex::Match &match) {
+        return match.entry.url == url && match.entry.timestamp == timestamp;
+    }));
+}
+
+void ScreenshotIndexTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ScreenshotIndexTest::init()
+{
+    QFile::remove(ScreenshotIndex::instance()->filePath());
+    QVERIFY(ScreenshotIndex::instance()->findSimilar(0, 64).isEmpty());
+}
+
+void ScreenshotIndexTest::testDistance_data()
+{
+    QTest::addColumn<quint64>("lhs");
+    QTest::addColumn<quint64>("rhs");
+    QTest::addColumn<int>("distance");
+
+    QTest::newRow("same") << quint64(0x0123456789abcdef) << quint64(0x0123456789abcdef) << 0;
+    QTest::newRow("one bit") << quint64(0) << quint64(1) << 1;
+    QTest::newRow("highest bit") << quint64(0) << (quint64(1) << 63) << 1;
+    QTest::newRow("some bits") << quint64(0b1011) << quint64(0b0001) << 2;
+    QTest::newRow("all bits") << quint64(0) << ~quint64(0) << 64;
+}
+
+void ScreenshotIndexTest::testDistance()
+{
+    QFETCH(quint64, lhs);
+    QFETCH(quint64, rhs);
+    QFETCH(int, distance);
+    QCOMPARE(ScreenshotIndex::distance(lhs, rhs), distance);
+    QCOMPARE(ScreenshotIndex::distance(rhs, lhs), distance);
+}
+
+void ScreenshotIndexTest::testDifferenceHash()
+{
+    QCOMPARE(ScreenshotIndex::differenceHash({}), quint64(0));
+
+    // Every row is all rising or all falling, so mirroring changes every bit.
+    constexpr quint64 hash = 0xff00ff0000ffff00;
+    const auto image = imageWithHash(hash);
+    QCOMPARE(ScreenshotIndex::differenceHash(image), hash);
+    // Scaling by a whole factor averages back to the same thumbnail.
+    const auto scaled = image.scaled(image.size() * 10, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    QCOMPARE(ScreenshotIndex::differenceHash(scaled), hash);
+    // Color images are hashed by brightness.
+    QCOMPARE(ScreenshotIndex::differenceHash(image.convertToFormat(QImage::Format_ARGB32)), hash);
+    const auto mirrored = image.mirrored(true, false);
+    QCOMPARE(ScreenshotIndex::distance(ScreenshotIndex::differenceHash(mirrored), hash), 64);
+}
+
+void ScreenshotIndexTest::testFindSimilar()
+{
+    constexpr quint64 hash = 0x0123456789abcdef;
+    const QUrl original(u"https://example.com/original.png"_s);
+    const QUrl duplicate(u"https://example.com/duplicate.png"_s);
+    const QUrl near(u"https://example.com/near.png"_s);
+    const QUrl threshold(u"https://example.com/threshold.png"_s);
+    const QUrl miss(u"https://example.com/miss.png"_s);
+    const QUrl unrelated(u"https://example.com/unrelated.png"_s);
+    addAndWait(hash, original, m_timestamp);
+    addAndWait(hash, duplicate, m_timestamp.addSecs(1));
+    addAndWait(hash ^ 0b111, near, m_timestamp.addSecs(2));
+    addAndWait(hash ^ 0b111111, threshold, m_timestamp.addSecs(3));
+    addAndWait(hash ^ 0b1111111, miss, m_timestamp.addSecs(4));
+    addAndWait(~hash, unrelated, m_timestamp.addSecs(5));
+
+    auto index = ScreenshotIndex::instance();
+    const auto matches = index->findSimilar(hash, ScreenshotIndex::defaultMaxDistance);
+    QCOMPARE(matches.size(), 4);
+    // Sorted by distance, then from newest to oldest.
+    QCOMPARE(matches[0].entry.url, duplicate);
+    QCOMPARE(matches[0].distance, 0);
+    QCOMPARE(matches[1].entry.url, original);
+    QCOMPARE(matches[1].distance, 0);
+    QCOMPARE(matches[2].entry.url, near);
+    QCOMPARE(matches[2].distance, 3);
+    QCOMPARE(matches[3].entry.url, threshold);
+    QCOMPARE(matches[3].distance, 6);
+
+    const auto duplicates = index->findSimilar(hash, 0);
+    QCOMPARE(duplicates.size(), 2);
+
+    // Looking up an indexed file doesn't return the file itself.
+    const auto similar = index->findSimilar(original, ScreenshotIndex::defaultMaxDistance);
+    QCOMPARE(similar.size(), 3);
+    QCOMPARE(similar[0].entry.url, duplicate);
+
+    QCOMPARE(index->findSimilar(hash, 64).size(), 6);
+}
+
+void ScreenshotIndexTest::testReplaceUrl()
+{
+    constexpr quint64 hash = 0xfedcba9876543210;
+    const QUrl url(u"https://example.com/replaced.png"_s);
+    addAndWait(hash, url, m_timestamp);
+    addAndWait(~hash, url, m_timestamp.addSecs(1));
+
+    auto index = ScreenshotIndex::instance();
+    QVERIFY(index->findSimilar(hash, ScreenshotIndex::defaultMaxDistance).isEmpty());
+    const auto matches = index->findSimilar(~hash, 0);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].entry.timestamp, m_timestamp.addSecs(1));
+}
+
+// The BK-tree must find exactly what comparing every entry would find.
+void ScreenshotIndexTest::testMatchesBruteForce()
+{
+    QRandomGenerator random(42);
+    QList<quint64> hashes;
+    const auto base = random.generate64();
+    for (int i = 0; i < 100; ++i) {
+        // Flip a few random bits so that many hashes are close to each other.
+        auto hash = base;
+        const int flips = random.bounded(12);
+        for (int j = 0; j < flips; ++j) {
+            hash ^= quint64(1) << random.bounded(64);
+        }
+        hashes.append(hash);
+        addAndWait(hash, QUrl(u"https://example.com/%1.png"_s.arg(i)), m_timestamp.addSecs(i));
+    }
+
+    auto index = ScreenshotIndex::instance();
+    for (int maxDistance : {0, 1, 3, ScreenshotIndex::defaultMaxDistance, 10}) {
+        for (int i = 0; i < 10; ++i) {
+            const auto query = i == 0 ? base : hashes[random.bounded(hashes.size())];
+            const auto expected = qsizetype(std::ranges::count_if(hashes, [&](quint64 hash) {
+                return ScreenshotIndex::distance(hash, query) <= maxDistance;
+            }));
+            const auto matches = index->findSimilar(query, maxDistance);
+            QCOMPARE(matches.size(), expected);
+            for (const auto &match : matches) {
+                QCOMPARE(match.distance, ScreenshotIndex::distance(match.entry.hash, query));
+                QVERIFY(match.distance <= maxDistance);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(ScreenshotIndexTest)
+
+#include "ScreenshotIndexTest.moc"